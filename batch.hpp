@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "exceptions.hpp"
+#include "hash.hpp"
+#include "type_list.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace f1d {
+
+namespace detail {
+
+/**
+ * Throw not_set_exception listing the fields missing from the mask.
+ */
+template <typename S, typename Mask>
+void throw_not_set(const Mask& set_fields)
+{
+    std::vector<unsigned int> indices;
+    std::vector<std::string> names;
+
+    for (unsigned int i = 0; i < S::num_fields; i++) {
+        if (!set_fields.test(i)) {
+            indices.push_back(i);
+            names.push_back(S::get_field_name(i));
+        }
+    }
+
+    F1D_THROW(not_set_exception()
+        << struct_name(S::get_struct_name())
+        << field_indices(indices)
+        << field_names(names));
+}
+
+template <typename S, typename Indices>
+struct batch_rows;
+
+/**
+ * Append rows to a vector of structs from one column per field, writing
+ * a field of every new row before moving to the next field.
+ */
+template <typename S, unsigned int... Is>
+struct batch_rows<S, index_list<Is...> >
+{
+    template <unsigned int I>
+    static int copy(S* rows, const void* const* columns, size_t n)
+    {
+        typedef typename type_at<I, typename S::field_types>::type T;
+        const T* column = static_cast<const T*>(columns[I]);
+
+        for (size_t r = 0; r < n; r++)
+            field_at<S, I>(rows[r]) = column[r];
+
+        return 0;
+    }
+
+    template <typename A>
+    static void append(std::vector<S, A>& out, const void* const* columns,
+        size_t n)
+    {
+        const size_t first = out.size();
+
+        out.resize(first + n);
+
+        try {
+            S* rows = out.data() + first;
+            const int expand[] = { 0, copy<Is>(rows, columns, n)... };
+            (void)expand;
+        }
+        catch (...) {
+            out.resize(first);
+            throw;
+        }
+    }
+};
+
+/**
+ * Append rows to every column of an SoA container.
+ */
+struct batch_columns
+{
+    const void* const* columns;
+    size_t n;
+
+    batch_columns(const void* const* columns, size_t n) :
+        columns(columns),
+        n(n)
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(V& column)
+    {
+        typedef typename V::value_type T;
+        const T* values = static_cast<const T*>(columns[I]);
+
+        // Grow geometrically, so appending many small batches stays linear
+        const size_t needed = column.size() + n;
+
+        if (needed > column.capacity())
+            column.reserve(std::max(needed, 2 * column.capacity()));
+
+        for (size_t r = 0; r < n; r++)
+            column.push_back(values[r]);
+    }
+};
+
+struct batch_truncate
+{
+    size_t size;
+
+    batch_truncate(size_t size) :
+        size(size)
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(V& column) const
+    {
+        column.truncate(size);
+    }
+};
+
+template <typename S, typename A>
+void batch_append(std::vector<S, A>& out, const void* const* columns,
+    size_t n)
+{
+    batch_rows<S, typename make_index_list<S::num_fields>::type>::append(
+        out, columns, n);
+}
+
+template <typename SoA>
+void batch_append(SoA& out, const void* const* columns, size_t n)
+{
+    const size_t size = out.size();
+
+    try {
+        batch_columns f(columns, n);
+        out.apply(f);
+    }
+    catch (...) {
+        out.apply(batch_truncate(size));
+        throw;
+    }
+}
+
+}
+
+}
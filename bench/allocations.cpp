@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "allocations.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+
+size_t num_allocations = 0;
+
+}
+
+void* operator new(size_t size)
+{
+    bench::num_allocations++;
+
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
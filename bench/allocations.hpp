@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace bench {
+
+/**
+ * Number of calls to the global operator new, replaced in
+ * allocations.cpp. The replacement lives in its own translation unit so
+ * the compiler cannot match the allocations it inlines against the
+ * deallocations.
+ */
+extern size_t num_allocations;
+
+}
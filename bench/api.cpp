@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * Google Benchmark suite for the members generated by F1D_STRUCT_MAKE,
+ * on structs of 1, 3, 16, 64 and 200 fields of mixed types. Every
+ * benchmark reports the time and the number of heap allocations per
+ * operation, counted by the operator new of allocations.cpp. Build with
+ * optimizations and the same include paths as the tests, e.g.
+ *
+ *   g++ -O2 -I.. -Iextra bench/api.cpp bench/allocations.cpp -o api \
+ *       -lbenchmark -lpthread
+ *   ./api --benchmark_filter=Factory
+ *
+ * Define F1D_VARIADIC_BACKEND to measure the variadic backend.
+ */
+
+#include "allocations.hpp"
+
+#include <f1d/fields.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/preprocessor/arithmetic/mod.hpp>
+#include <boost/preprocessor/repetition/repeat.hpp>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+/*
+ * Field i of the generated structs is named fi, its type cycles through
+ * int, double, char and std::string.
+ */
+#define BENCH_FIELD_TYPES (int, double, char, std::string)
+
+#define BENCH_FIELD(z, i, nothing) \
+    ( (BOOST_PP_CAT(f, i), \
+        BOOST_PP_TUPLE_ELEM(4, BOOST_PP_MOD(i, 4), BENCH_FIELD_TYPES)) )
+
+#define BENCH_FIELDS(N) \
+    BOOST_PP_REPEAT(N, BENCH_FIELD, ~)
+
+namespace bench {
+
+/**
+ * Names the generated types that are not members of the struct.
+ */
+template <typename S>
+struct bench_struct;
+
+}
+
+#define BENCH_STRUCT(N) \
+namespace bench { \
+namespace BOOST_PP_CAT(s, N) { \
+    F1D_STRUCT_MAKE(record, BENCH_FIELDS(N)) \
+} \
+template <> \
+struct bench_struct<BOOST_PP_CAT(s, N)::record> \
+{ \
+    typedef BOOST_PP_CAT(s, N)::record_factory factory; \
+    template <unsigned int I> \
+    struct wrapper : \
+        BOOST_PP_CAT(s, N)::traits::field_wrapper_type< \
+            BOOST_PP_CAT(s, N)::record, I> \
+    { \
+    }; \
+}; \
+}
+
+BENCH_STRUCT(1)
+BENCH_STRUCT(3)
+BENCH_STRUCT(16)
+BENCH_STRUCT(64)
+BENCH_STRUCT(200)
+
+namespace bench {
+
+template <typename T>
+void sample(T& value, unsigned int i)
+{
+    value = static_cast<T>(i + 1);
+}
+
+inline void sample(std::string& value, unsigned int i)
+{
+    // Long enough to be allocated on the heap
+    value = "a string field value " + std::to_string(i);
+}
+
+struct filler
+{
+    template <unsigned int I, typename S, typename V>
+    void operator ()(V& v) const
+    {
+        sample(v, I);
+    }
+};
+
+struct incrementer
+{
+    template <unsigned int I, typename S, typename V>
+    void operator ()(V& v) const
+    {
+        v = v + V(1);
+    }
+
+    template <unsigned int I, typename S>
+    void operator ()(std::string& v) const
+    {
+        v[0]++;
+    }
+};
+
+/*
+ * Read a field into a register, an operand already in memory would let
+ * DoNotOptimize compile to nothing.
+ */
+template <typename V>
+void read_field(const V& v)
+{
+    V value = v;
+    benchmark::DoNotOptimize(value);
+}
+
+inline void read_field(const std::string& v)
+{
+    benchmark::DoNotOptimize(v.data()[0]);
+}
+
+struct field_touch
+{
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V& v) const
+    {
+        read_field(v);
+    }
+};
+
+template <typename S>
+S make_record()
+{
+    S obj;
+    obj.apply(filler());
+    return obj;
+}
+
+template <typename S, typename Indices>
+struct wrapper_tuple;
+
+/**
+ * One field wrapper per field of S.
+ */
+template <typename S, unsigned int... Is>
+struct wrapper_tuple<S, f1d::index_list<Is...> >
+{
+    typedef std::tuple<typename bench_struct<S>::template
+        wrapper<Is>::type...> type;
+};
+
+template <typename S, unsigned int... Is>
+typename wrapper_tuple<S, f1d::index_list<Is...> >::type make_wrappers(
+    const S& obj, f1d::index_list<Is...>)
+{
+    return typename wrapper_tuple<S, f1d::index_list<Is...> >::type(
+        typename bench_struct<S>::template wrapper<Is>::type(obj)...);
+}
+
+/*
+ * Set every field of the factory from wrappers built beforehand, so the
+ * factory benchmarks do not measure the copies into the wrappers.
+ */
+template <typename S, typename Wrappers, unsigned int... Is>
+void set_fields(const Wrappers& wrappers,
+    typename bench_struct<S>::factory& f, f1d::index_list<Is...>)
+{
+    const int expand[] = { 0, (std::get<Is>(wrappers)(f), 0)... };
+    (void)expand;
+}
+
+template <typename S, unsigned int... Is>
+void convert_fields(const S& obj, f1d::index_list<Is...>)
+{
+    const int expand[] = { 0, (benchmark::DoNotOptimize(
+        static_cast<typename bench_struct<S>::template wrapper<Is>::type::
+            value_type>(typename bench_struct<S>::template wrapper<Is>::
+                type(obj))), 0)... };
+    (void)expand;
+}
+
+/**
+ * Run the body of a benchmark and report the allocations per iteration.
+ */
+template <typename Body>
+void measure(benchmark::State& state, Body body)
+{
+    const size_t allocations = num_allocations;
+
+    for (auto _ : state)
+        body();
+
+    state.counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(num_allocations - allocations),
+        benchmark::Counter::kAvgIterations);
+}
+
+template <typename S>
+void GetFieldIndex(benchmark::State& state)
+{
+    const std::string name = S::get_field_name(S::num_fields / 2);
+
+    measure(state, [&]() {
+        benchmark::DoNotOptimize(S::get_field_index(name));
+    });
+}
+
+template <typename S>
+void TryGetFieldIndex(benchmark::State& state)
+{
+    const std::string name = S::get_field_name(S::num_fields - 1);
+    unsigned int index;
+
+    measure(state, [&]() {
+        benchmark::DoNotOptimize(S::try_get_field_index(name.data(),
+            name.size(), index));
+    });
+}
+
+template <typename S>
+void GetFieldName(benchmark::State& state)
+{
+    unsigned int index = 0;
+
+    measure(state, [&]() {
+        benchmark::DoNotOptimize(S::get_field_name(index));
+        index = index + 1 < S::num_fields ? index + 1 : 0;
+    });
+}
+
+template <typename S>
+void Factory(benchmark::State& state)
+{
+    typedef typename f1d::make_index_list<S::num_fields>::type indices;
+
+    const typename wrapper_tuple<S, indices>::type wrappers =
+        make_wrappers(make_record<S>(), indices());
+    typename bench_struct<S>::factory f;
+
+    measure(state, [&]() {
+        f.begin();
+        set_fields<S>(wrappers, f, indices());
+        f.end();
+        benchmark::DoNotOptimize(&f.get());
+    });
+}
+
+template <typename S>
+void FactoryTake(benchmark::State& state)
+{
+    typedef typename f1d::make_index_list<S::num_fields>::type indices;
+
+    const typename wrapper_tuple<S, indices>::type wrappers =
+        make_wrappers(make_record<S>(), indices());
+    typename bench_struct<S>::factory f;
+
+    measure(state, [&]() {
+        f.begin();
+        set_fields<S>(wrappers, f, indices());
+        f.end();
+        S taken = f.take();
+        benchmark::DoNotOptimize(&taken);
+    });
+}
+
+template <typename S>
+void Apply(benchmark::State& state)
+{
+    S obj = make_record<S>();
+
+    measure(state, [&]() {
+        obj.apply(incrementer());
+        benchmark::ClobberMemory();
+    });
+}
+
+template <typename S>
+void CApply(benchmark::State& state)
+{
+    const S obj = make_record<S>();
+
+    measure(state, [&]() {
+        obj.capply(field_touch());
+    });
+}
+
+template <typename S>
+void VisitField(benchmark::State& state)
+{
+    const S obj = make_record<S>();
+    unsigned int index = 0;
+
+    measure(state, [&]() {
+        obj.cvisit_field(index, field_touch());
+        index = index + 1 < S::num_fields ? index + 1 : 0;
+    });
+}
+
+template <typename S>
+void WrapperConvert(benchmark::State& state)
+{
+    typedef typename f1d::make_index_list<S::num_fields>::type indices;
+
+    const S obj = make_record<S>();
+
+    measure(state, [&]() {
+        convert_fields(obj, indices());
+    });
+}
+
+template <typename S>
+void Equal(benchmark::State& state)
+{
+    const S a = make_record<S>();
+    const S b = a;
+
+    measure(state, [&]() {
+        benchmark::DoNotOptimize(a == b);
+    });
+}
+
+template <typename S>
+void Hash(benchmark::State& state)
+{
+    const S obj = make_record<S>();
+
+    measure(state, [&]() {
+        benchmark::DoNotOptimize(f1d::hash_struct(obj));
+    });
+}
+
+template <typename S>
+void Serialize(benchmark::State& state)
+{
+    const S obj = make_record<S>();
+    std::vector<char> buffer(obj.get_serialized_size());
+
+    measure(state, [&]() {
+        benchmark::DoNotOptimize(obj.serialize(buffer.data(),
+            buffer.size()));
+    });
+}
+
+template <typename S>
+void Deserialize(benchmark::State& state)
+{
+    const S obj = make_record<S>();
+    std::vector<char> buffer(obj.get_serialized_size());
+    S target;
+
+    obj.serialize(buffer.data(), buffer.size());
+
+    measure(state, [&]() {
+        benchmark::DoNotOptimize(target.deserialize(buffer.data(),
+            buffer.size()));
+    });
+}
+
+}
+
+#define BENCH_REGISTER(N) \
+    BENCHMARK_TEMPLATE(GetFieldIndex, s##N::record); \
+    BENCHMARK_TEMPLATE(TryGetFieldIndex, s##N::record); \
+    BENCHMARK_TEMPLATE(GetFieldName, s##N::record); \
+    BENCHMARK_TEMPLATE(Factory, s##N::record); \
+    BENCHMARK_TEMPLATE(FactoryTake, s##N::record); \
+    BENCHMARK_TEMPLATE(Apply, s##N::record); \
+    BENCHMARK_TEMPLATE(CApply, s##N::record); \
+    BENCHMARK_TEMPLATE(VisitField, s##N::record); \
+    BENCHMARK_TEMPLATE(WrapperConvert, s##N::record); \
+    BENCHMARK_TEMPLATE(Equal, s##N::record); \
+    BENCHMARK_TEMPLATE(Hash, s##N::record); \
+    BENCHMARK_TEMPLATE(Serialize, s##N::record); \
+    BENCHMARK_TEMPLATE(Deserialize, s##N::record);
+
+namespace bench {
+
+BENCH_REGISTER(1)
+BENCH_REGISTER(3)
+BENCH_REGISTER(16)
+BENCH_REGISTER(64)
+BENCH_REGISTER(200)
+
+}
+
+BENCHMARK_MAIN();
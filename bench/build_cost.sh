@@ -0,0 +1,157 @@
+#!/bin/sh
+#
+# Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+#
+# This file is part of f1d.
+#
+# f1d is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# f1d is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Measure the build cost of generated headers with N structs of M fields
+# each, for both backends: preprocessing time, compile time, peak compiler
+# memory and the size of the .text sections of the object, in total, per
+# struct and per field. The per struct and per field sizes leave out the
+# code emitted by the headers alone, measured on a file without structs.
+# A second table splits the size of the code symbols of each object by
+# the part of the API they belong to. Use the same CXX and CXXFLAGS as the
+# tests, e.g.
+#
+#   CXX=g++ CXXFLAGS="-I.. -Iextra -O2" STRUCTS="1 10" FIELDS="10 100" \
+#       bench/build_cost.sh
+#
+# The peak memory is read with GNU time, set TIME to its path if it is not
+# /usr/bin/time. It is reported as - when GNU time is not available.
+#
+
+set -e
+
+. "$(dirname "$0")/common.sh"
+
+STRUCTS=${STRUCTS:-1 10}
+FIELDS=${FIELDS:-10 100 250}
+TIME=${TIME:-/usr/bin/time}
+CATEGORIES="factory wrappers apply lookup serialize comparison other"
+
+# Run a command and print the peak memory in kilobytes
+peak_memory()
+{
+    if [ -x "$TIME" ]; then
+        "$TIME" -f %M -o "$WORK_DIR/mem" "$@"
+        cat "$WORK_DIR/mem"
+    else
+        "$@"
+        echo -
+    fi
+}
+
+# Print the total size of the .text sections of an object
+text_size()
+{
+    size -A "$1" | awk '$1 ~ /^\.text/ { total += $2 } END { print total + 0 }'
+}
+
+# Print the total size of the code symbols of an object in each category,
+# in the order of CATEGORIES. A symbol is counted in the first category
+# its demangled name matches, apply includes capply, dispatch_field and
+# the functors, and other is mostly the exception and standard library
+# code. Constructor and destructor aliases are counted once
+category_sizes()
+{
+    nm -C -S -t d --size-sort "$1" | awk '
+        $3 ~ /^[tTwW]$/ && !seen[$0]++ {
+            name = $0
+            sub(/^[^ ]+ [^ ]+ [^ ]+ /, "", name)
+            if (name ~ /get_field_index|field_table<.*>::find|name_equals/)
+                c = "lookup"
+            else if (name ~ /serializ/)
+                c = "serialize"
+            else if (name ~ /operator(==|!=|<[ (])|struct_(equal|less)/)
+                c = "comparison"
+            else if (name ~ /::c?apply<|dispatch_field|counter::operator/)
+                c = "apply"
+            else if (name ~ /::types::/)
+                c = "wrappers"
+            else if (name ~ /_basic_factory</)
+                c = "factory"
+            else
+                c = "other"
+            total[c] += $2
+        }
+        END {
+            n = split("'"$CATEGORIES"'", names, " ")
+            for (i = 1; i <= n; i++)
+                printf "%s ", total[names[i]] + 0
+            printf "\n"
+        }'
+}
+
+printf "%-8s %7s %6s %9s %9s %10s %10s %11s %10s\n" backend structs \
+    fields "pp (ms)" "cc (ms)" "mem (KB)" "text (B)" "per struct" \
+    "per field"
+
+# Size of the code emitted by the headers alone
+generate 0 0 "$WORK_DIR/base.cpp"
+$CXX $CXXFLAGS -c "$WORK_DIR/base.cpp" -o "$WORK_DIR/base.o"
+pp_base=$(text_size "$WORK_DIR/base.o")
+$CXX $CXXFLAGS -DF1D_VARIADIC_BACKEND -c "$WORK_DIR/base.cpp" \
+    -o "$WORK_DIR/base.o"
+variadic_base=$(text_size "$WORK_DIR/base.o")
+
+: > "$WORK_DIR/categories"
+
+for n in $STRUCTS; do
+    for m in $FIELDS; do
+        src="$WORK_DIR/structs_${n}_$m.cpp"
+        obj="$WORK_DIR/structs_${n}_$m.o"
+        generate $n $m "$src"
+
+        for backend in pp variadic; do
+            if [ $backend = variadic ]; then
+                flags="$CXXFLAGS -DF1D_VARIADIC_BACKEND"
+                base=$variadic_base
+            else
+                flags="$CXXFLAGS"
+                base=$pp_base
+            fi
+
+            pp_best=$(best_time $CXX $flags -E "$src" -o /dev/null)
+            cc_best=$(best_time $CXX $flags -c "$src" -o "$obj")
+
+            mem=$(peak_memory $CXX $flags -c "$src" -o "$obj")
+            text=$(text_size "$obj")
+            extra=$((text - base))
+
+            printf "%-8s %7s %6s %9s %9s %10s %10s %11s %10s\n" $backend \
+                $n $m $pp_best $cc_best $mem $text $((extra / n)) \
+                $((extra / (n * m)))
+
+            echo $backend $n $m $(category_sizes "$obj") \
+                >> "$WORK_DIR/categories"
+        done
+    done
+done
+
+echo
+printf "%-8s %7s %6s" backend structs fields
+for c in $CATEGORIES; do
+    printf " %10s" $c
+done
+printf "\n"
+
+while read backend n m sizes; do
+    printf "%-8s %7s %6s" $backend $n $m
+    for size in $sizes; do
+        printf " %10s" $size
+    done
+    printf "\n"
+done < "$WORK_DIR/categories"
@@ -0,0 +1,113 @@
+#
+# Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+#
+# This file is part of f1d.
+#
+# f1d is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# f1d is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Helpers shared by the compile time benchmarks, sourced by
+# compile_time.sh and build_cost.sh. Sets CXX, RUNS and a WORK_DIR that
+# is removed on exit.
+#
+
+CXX=${CXX:-g++}
+RUNS=${RUNS:-3}
+WORK_DIR=$(mktemp -d)
+
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Write a translation unit with $1 structs of $2 fields and one function
+# per struct that uses the factory, the field wrappers, apply, capply,
+# the name lookup, the comparison and the serialization
+generate()
+{
+    n=$1
+    m=$2
+    out=$3
+
+    {
+        echo '#include <f1d/fields.hpp>'
+        echo '#include <string>'
+        s=0
+        while [ $s -lt $n ]; do
+            echo "namespace s$s {"
+            echo 'F1D_STRUCT_MAKE(record,'
+            i=0
+            while [ $i -lt $m ]; do
+                case $((i % 4)) in
+                    0) type=int ;;
+                    1) type=double ;;
+                    2) type=char ;;
+                    3) type=std::string ;;
+                esac
+                echo "    ( (f$i, $type) )"
+                i=$((i + 1))
+            done
+            echo ')'
+            echo 'struct counter {'
+            echo '    size_t total = 0;'
+            echo '    template <unsigned int I, typename S, typename V>'
+            echo '    void operator ()(const V& v) { total += sizeof(v); }'
+            echo '};'
+            echo '}'
+            echo "size_t use_s$s(const s$s::record& in, const char* name,"
+            echo '    void* buffer, size_t size) {'
+            echo "    using namespace s$s;"
+            echo '    record_factory f;'
+            echo '    f.begin();'
+            i=0
+            while [ $i -lt $m ]; do
+                echo "    (types::f${i}_f(in))(f);"
+                i=$((i + 1))
+            done
+            echo '    f.end();'
+            echo '    record r = f.take();'
+            echo '    counter c;'
+            echo '    r.capply(c);'
+            echo '    r.apply(c);'
+            echo '    return c.total + record::get_field_index(name) +'
+            echo '        r.serialize(buffer, size) + (r == in);'
+            echo '}'
+            s=$((s + 1))
+        done
+    } > "$out"
+}
+
+now()
+{
+    date +%s%N
+}
+
+# Run a command and print the elapsed time in milliseconds
+elapsed()
+{
+    start=$(now)
+    "$@"
+    echo $((($(now) - start) / 1000000))
+}
+
+# Run a command RUNS times and print the best elapsed time in milliseconds
+best_time()
+{
+    best=
+    run=0
+    while [ $run -lt $RUNS ]; do
+        t=$(elapsed "$@")
+        if [ -z "$best" ] || [ $t -lt $best ]; then
+            best=$t
+        fi
+        run=$((run + 1))
+    done
+    echo $best
+}
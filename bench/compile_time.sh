@@ -0,0 +1,43 @@
+#!/bin/sh
+#
+# Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+#
+# This file is part of f1d.
+#
+# f1d is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# f1d is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Compare the compile time of the preprocessor and variadic backends on
+# generated structs. Use the same CXX and CXXFLAGS as the tests, e.g.
+#
+#   CXX=g++ CXXFLAGS="-I.. -Iextra" bench/compile_time.sh 10 100 250
+#
+
+set -e
+
+. "$(dirname "$0")/common.sh"
+
+SIZES=${*:-10 100 250}
+
+printf "%8s %14s %14s\n" fields "pp (ms)" "variadic (ms)"
+
+for fields in $SIZES; do
+    src="$WORK_DIR/struct_$fields.cpp"
+    generate 1 $fields "$src"
+
+    pp_best=$(best_time $CXX $CXXFLAGS -c "$src" -o "$WORK_DIR/pp.o")
+    va_best=$(best_time $CXX $CXXFLAGS -DF1D_VARIADIC_BACKEND -c "$src" \
+        -o "$WORK_DIR/va.o")
+
+    printf "%8s %14s %14s\n" $fields $pp_best $va_best
+done
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * Compare the reduction kernels against the naive capply loop over a
+ * vector of structs and against the kernels over an SoA container. Build
+ * with optimizations and the same include paths as the tests, e.g.
+ *
+ *   g++ -O3 -march=native -I.. -Iextra bench/reduce.cpp -o reduce
+ *   ./reduce 10000000
+ */
+
+#include <f1d/reduce.hpp>
+#include <f1d/soa.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define BENCH_FIELDS \
+    ( (id,       long  ) ) \
+    ( (price,    double) ) \
+    ( (quantity, int   ) ) \
+    ( (side,     char  ) ) \
+    ( (weight,   float ) )
+
+namespace bench {
+
+F1D_STRUCT_MAKE(record, BENCH_FIELDS)
+
+F1D_SOA_MAKE(record, BENCH_FIELDS)
+
+/**
+ * Sum of a single field through capply, the loop being replaced.
+ */
+template <typename Field>
+struct capply_sum
+{
+    typename f1d::sum_type<typename Field::value_type>::type total;
+
+    capply_sum() :
+        total()
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V& v)
+    {
+        add(v, std::integral_constant<bool, I == Field::index>());
+    }
+
+    template <typename V>
+    void add(const V& v, std::true_type)
+    {
+        total += v;
+    }
+
+    template <typename V>
+    void add(const V&, std::false_type)
+    {
+    }
+};
+
+template <typename Field>
+typename f1d::sum_type<typename Field::value_type>::type naive_sum(
+    const std::vector<record>& records)
+{
+    capply_sum<Field> f;
+
+    for (size_t i = 0; i < records.size(); i++)
+        records[i].capply(f);
+
+    return f.total;
+}
+
+template <typename Function>
+void run(const char* name, Function f, size_t n)
+{
+    const int runs = 5;
+    double best = 0;
+    double result = 0;
+
+    for (int r = 0; r < runs; r++) {
+
+        const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+
+        result = static_cast<double>(f());
+
+        const double elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (r == 0 || elapsed < best)
+            best = elapsed;
+    }
+
+    std::printf("%-28s %10.3f ms %8.3f ns/record  (%g)\n", name,
+        best * 1e3, best * 1e9 / n, result);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace bench;
+
+    const size_t n = argc > 1 ? std::strtoul(argv[1], 0, 10) : 10000000;
+
+    std::vector<record> aos(n);
+    record_soa soa;
+
+    soa.reserve(n);
+
+    for (size_t i = 0; i < n; i++) {
+        aos[i].id = static_cast<long>(i);
+        aos[i].price = (i % 1000) * 0.01;
+        aos[i].quantity = static_cast<int>(i % 100) - 50;
+        aos[i].side = i % 2 ? 'B' : 'S';
+        aos[i].weight = (i % 10) * 0.5f;
+        soa.push_back(aos[i]);
+    }
+
+    std::printf("%lu records of %lu bytes\n",
+        static_cast<unsigned long>(n),
+        static_cast<unsigned long>(sizeof(record)));
+
+    run("sum price, capply", [&]() {
+        return naive_sum<types::price_f>(aos); }, n);
+    run("sum price, AoS", [&]() {
+        return f1d::sum<types::price_f>(aos); }, n);
+    run("sum price, SoA", [&]() {
+        return f1d::sum<types::price_f>(soa); }, n);
+
+    run("sum quantity, capply", [&]() {
+        return naive_sum<types::quantity_f>(aos); }, n);
+    run("sum quantity, AoS", [&]() {
+        return f1d::sum<types::quantity_f>(aos); }, n);
+    run("sum quantity, SoA", [&]() {
+        return f1d::sum<types::quantity_f>(soa); }, n);
+
+    run("max weight, AoS", [&]() {
+        return f1d::max<types::weight_f>(aos); }, n);
+    run("max weight, SoA", [&]() {
+        return f1d::max<types::weight_f>(soa); }, n);
+
+    run("count_if quantity, AoS", [&]() {
+        return f1d::count_if<types::quantity_f>(aos,
+            [](int q) { return q > 0; }); }, n);
+    run("count_if quantity, SoA", [&]() {
+        return f1d::count_if<types::quantity_f>(soa,
+            [](int q) { return q > 0; }); }, n);
+
+    return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <boost/align/aligned_alloc.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+ * Default alignment, in bytes, of the storage of each column.
+ */
+#ifndef F1D_COLUMN_ALIGNMENT
+#define F1D_COLUMN_ALIGNMENT 64
+#endif
+
+namespace f1d {
+
+/**
+ * Contiguous, aligned storage for the values of a single field.
+ */
+template <typename T>
+class column
+{
+public:
+
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef size_t size_type;
+
+    static const size_t alignment =
+        F1D_COLUMN_ALIGNMENT > alignof(T) ? F1D_COLUMN_ALIGNMENT : alignof(T);
+
+private:
+
+    T* _data;
+    size_t _size;
+    size_t _capacity;
+
+    static T* allocate(size_t n)
+    {
+        if (n == 0)
+            return 0;
+
+        void* p = boost::alignment::aligned_alloc(alignment, n * sizeof(T));
+
+        if (p == 0)
+            throw std::bad_alloc();
+
+        return static_cast<T*>(p);
+    }
+
+    static void deallocate(T* p)
+    {
+        boost::alignment::aligned_free(p);
+    }
+
+    void destroy_from(size_t n)
+    {
+        for (size_t i = n; i < _size; i++)
+            _data[i].~T();
+
+        _size = std::min(_size, n);
+    }
+
+    void grow(size_t n)
+    {
+        if (n <= _capacity)
+            return;
+
+        reserve(std::max(n, 2 * _capacity));
+    }
+
+public:
+
+    column() :
+        _data(0),
+        _size(0),
+        _capacity(0)
+    {
+    }
+
+    column(const column& other) :
+        _data(allocate(other._size)),
+        _size(0),
+        _capacity(other._size)
+    {
+        try {
+            for (; _size < other._size; _size++)
+                new (_data + _size) T(other._data[_size]);
+        }
+        catch (...) {
+            destroy_from(0);
+            deallocate(_data);
+            throw;
+        }
+    }
+
+    column(column&& other) noexcept :
+        _data(other._data),
+        _size(other._size),
+        _capacity(other._capacity)
+    {
+        other._data = 0;
+        other._size = 0;
+        other._capacity = 0;
+    }
+
+    ~column()
+    {
+        destroy_from(0);
+        deallocate(_data);
+    }
+
+    column& operator =(column other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void swap(column& other) noexcept
+    {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_capacity, other._capacity);
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    size_t capacity() const
+    {
+        return _capacity;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    T* data()
+    {
+        return _data;
+    }
+
+    const T* data() const
+    {
+        return _data;
+    }
+
+    iterator begin()
+    {
+        return _data;
+    }
+
+    iterator end()
+    {
+        return _data + _size;
+    }
+
+    const_iterator begin() const
+    {
+        return _data;
+    }
+
+    const_iterator end() const
+    {
+        return _data + _size;
+    }
+
+    T& operator [](size_t i)
+    {
+        return _data[i];
+    }
+
+    const T& operator [](size_t i) const
+    {
+        return _data[i];
+    }
+
+    void reserve(size_t n)
+    {
+        if (n <= _capacity)
+            return;
+
+        T* data = allocate(n);
+        size_t i = 0;
+
+        try {
+            for (; i < _size; i++)
+                new (data + i) T(std::move_if_noexcept(_data[i]));
+        }
+        catch (...) {
+            for (size_t j = 0; j < i; j++)
+                data[j].~T();
+            deallocate(data);
+            throw;
+        }
+
+        const size_t size = _size;
+        destroy_from(0);
+        deallocate(_data);
+
+        _data = data;
+        _size = size;
+        _capacity = n;
+    }
+
+    void push_back(const T& value)
+    {
+        if (_size == _capacity) {
+            // value may live inside the current storage
+            T copy(value);
+            grow(_size + 1);
+            new (_data + _size) T(std::move(copy));
+        }
+        else {
+            new (_data + _size) T(value);
+        }
+
+        _size++;
+    }
+
+    void pop_back()
+    {
+        destroy_from(_size - 1);
+    }
+
+    /**
+     * Destroy every element past the first n ones.
+     */
+    void truncate(size_t n)
+    {
+        destroy_from(n);
+    }
+
+    void resize(size_t n, const T& value = T())
+    {
+        if (n <= _size) {
+            destroy_from(n);
+            return;
+        }
+
+        const T copy(value);
+        reserve(n);
+
+        for (; _size < n; _size++)
+            new (_data + _size) T(copy);
+    }
+
+    void clear()
+    {
+        destroy_from(0);
+    }
+};
+
+template <typename T>
+const size_t column<T>::alignment;
+
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "hash.hpp"
+
+#include <cstring>
+
+namespace f1d {
+
+namespace detail {
+
+template <typename S, unsigned int I,
+    bool End = (I == S::num_fields),
+    bool Bitwise = is_bitwise_field<S>(I)>
+struct struct_equal
+{
+    static const unsigned int next = bitwise_run_end<S>(I);
+
+    static bool equal(const S& a, const S& b)
+    {
+        const size_t begin = S::get_field_offset(I);
+        const size_t end = S::get_field_offset(next - 1) +
+            S::get_type_size(next - 1);
+
+        return std::memcmp(reinterpret_cast<const char*>(&a) + begin,
+            reinterpret_cast<const char*>(&b) + begin, end - begin) == 0 &&
+            struct_equal<S, next>::equal(a, b);
+    }
+};
+
+template <typename S, unsigned int I>
+struct struct_equal<S, I, false, false>
+{
+    static bool equal(const S& a, const S& b)
+    {
+        return field_at<S, I>(a) == field_at<S, I>(b) &&
+            struct_equal<S, I + 1>::equal(a, b);
+    }
+};
+
+template <typename S, unsigned int I, bool Bitwise>
+struct struct_equal<S, I, true, Bitwise>
+{
+    static bool equal(const S&, const S&)
+    {
+        return true;
+    }
+};
+
+template <typename S, unsigned int... Is>
+struct fields_less;
+
+template <typename S, unsigned int I, unsigned int... Is>
+struct fields_less<S, I, Is...>
+{
+    static bool less(const S& a, const S& b)
+    {
+        if (field_at<S, I>(a) < field_at<S, I>(b))
+            return true;
+
+        if (field_at<S, I>(b) < field_at<S, I>(a))
+            return false;
+
+        return fields_less<S, Is...>::less(a, b);
+    }
+};
+
+template <typename S>
+struct fields_less<S>
+{
+    static bool less(const S&, const S&)
+    {
+        return false;
+    }
+};
+
+template <typename S, typename Indices>
+struct struct_less;
+
+template <typename S, unsigned int... Is>
+struct struct_less<S, index_list<Is...> > :
+    fields_less<S, Is...>
+{
+};
+
+}
+
+/**
+ * Field-wise equality of two f1d structs, stopping at the first field
+ * that differs. Runs of adjacent bitwise hashable fields are compared
+ * with a single memcmp, so padding is never compared.
+ */
+template <typename S>
+bool struct_equal(const S& a, const S& b)
+{
+    return detail::struct_equal<S, 0>::equal(a, b);
+}
+
+/**
+ * Lexicographic comparison of two f1d structs in field declaration
+ * order, using only operator < of the fields.
+ */
+template <typename S>
+bool struct_less(const S& a, const S& b)
+{
+    return detail::struct_less<S,
+        typename make_index_list<S::num_fields>::type>::less(a, b);
+}
+
+/**
+ * Lexicographic comparator of a subset of the fields, given as field
+ * wrappers, e.g. compare_by<types::field1_f, types::field3_f>.
+ */
+template <typename... Fields>
+struct compare_by
+{
+    template <typename S>
+    bool operator ()(const S& a, const S& b) const
+    {
+        return detail::fields_less<S, Fields::index...>::less(a, b);
+    }
+};
+
+}
@@ -0,0 +1,421 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "exceptions.hpp"
+#include "type_list.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace f1d {
+
+/**
+ * Category of a field type, for engines that handle fields without
+ * knowing their static types.
+ */
+enum type_tag
+{
+    other_tag = 0,
+    bool_tag,
+    char_tag,
+    int8_tag,
+    int16_tag,
+    int32_tag,
+    int64_tag,
+    uint8_tag,
+    uint16_tag,
+    uint32_tag,
+    uint64_tag,
+    float_tag,
+    double_tag,
+    long_double_tag,
+    string_tag
+};
+
+namespace detail {
+
+template <typename T, bool Integral = std::is_integral<T>::value>
+struct integral_tag
+{
+    static const type_tag value = other_tag;
+};
+
+template <typename T>
+struct integral_tag<T, true>
+{
+    static const type_tag value = std::is_signed<T>::value ?
+        (sizeof(T) == 1 ? int8_tag : sizeof(T) == 2 ? int16_tag :
+         sizeof(T) == 4 ? int32_tag : sizeof(T) == 8 ? int64_tag :
+         other_tag) :
+        (sizeof(T) == 1 ? uint8_tag : sizeof(T) == 2 ? uint16_tag :
+         sizeof(T) == 4 ? uint32_tag : sizeof(T) == 8 ? uint64_tag :
+         other_tag);
+};
+
+}
+
+template <typename T>
+struct type_tag_of
+{
+    static const type_tag value = detail::integral_tag<T>::value;
+};
+
+template <>
+struct type_tag_of<bool>
+{
+    static const type_tag value = bool_tag;
+};
+
+template <>
+struct type_tag_of<char>
+{
+    static const type_tag value = char_tag;
+};
+
+template <>
+struct type_tag_of<float>
+{
+    static const type_tag value = float_tag;
+};
+
+template <>
+struct type_tag_of<double>
+{
+    static const type_tag value = double_tag;
+};
+
+template <>
+struct type_tag_of<long double>
+{
+    static const type_tag value = long_double_tag;
+};
+
+template <>
+struct type_tag_of<std::string>
+{
+    static const type_tag value = string_tag;
+};
+
+/**
+ * Type-erased description of a field. The operations receive pointers to
+ * the field itself, obtained from a pointer to the struct with field(),
+ * and are null when the field type does not support them: compare needs
+ * operator <, hash needs std::hash, to_string needs operator << and
+ * from_string needs operator >> on standard streams.
+ */
+struct field_descriptor
+{
+    typedef int (*compare_function)(const void* a, const void* b);
+    typedef size_t (*hash_function)(const void* field);
+    typedef std::string (*to_string_function)(const void* field);
+    typedef bool (*from_string_function)(void* field, const char* text,
+        size_t length);
+
+    unsigned int index;
+    const char* name;
+    const char* type_name;
+    size_t offset;
+    size_t size;
+    size_t alignment;
+    type_tag tag;
+    compare_function compare;
+    hash_function hash;
+    to_string_function to_string;
+    from_string_function from_string;
+
+    const void* field(const void* obj) const
+    {
+        return static_cast<const char*>(obj) + offset;
+    }
+
+    void* field(void* obj) const
+    {
+        return static_cast<char*>(obj) + offset;
+    }
+};
+
+/**
+ * Type-erased description of a struct and its fields.
+ */
+struct struct_descriptor
+{
+    typedef error_code (*find_function)(const char* name, size_t length,
+        unsigned int& index);
+
+    const char* name;
+    size_t size;
+    size_t alignment;
+    unsigned int num_fields;
+    const field_descriptor* fields;
+    find_function find;
+
+    /**
+     * Descriptor of the field with the given name, null if not found.
+     */
+    const field_descriptor* find_field(const char* field_name,
+        size_t length) const
+    {
+        unsigned int index;
+        return find(field_name, length, index) == no_error ?
+            &fields[index] : 0;
+    }
+
+    const field_descriptor* find_field(const char* field_name) const
+    {
+        return find_field(field_name, std::strlen(field_name));
+    }
+
+    const field_descriptor* find_field(const std::string& field_name) const
+    {
+        return find_field(field_name.data(), field_name.size());
+    }
+};
+
+namespace detail {
+
+template <typename T>
+class has_less
+{
+    template <typename U>
+    static auto test(int) -> decltype(
+        std::declval<const U&>() < std::declval<const U&>(),
+        std::true_type());
+
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+template <typename T>
+class has_hash
+{
+    template <typename U>
+    static auto test(int) -> decltype(
+        std::hash<U>()(std::declval<const U&>()),
+        std::true_type());
+
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+template <typename T>
+class has_output
+{
+    template <typename U>
+    static auto test(int) -> decltype(
+        std::declval<std::ostream&>() << std::declval<const U&>(),
+        std::true_type());
+
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+template <typename T>
+class has_input
+{
+    template <typename U>
+    static auto test(int) -> decltype(
+        std::declval<std::istream&>() >> std::declval<U&>(),
+        std::true_type());
+
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+template <typename T>
+struct field_operations
+{
+    static int compare(const void* a, const void* b)
+    {
+        const T& x = *static_cast<const T*>(a);
+        const T& y = *static_cast<const T*>(b);
+        return x < y ? -1 : (y < x ? 1 : 0);
+    }
+
+    static size_t hash(const void* field)
+    {
+        return std::hash<T>()(*static_cast<const T*>(field));
+    }
+
+    static std::string to_string(const void* field)
+    {
+        std::ostringstream out;
+
+        if (std::is_floating_point<T>::value)
+            out.precision(std::numeric_limits<T>::max_digits10);
+
+        out << *static_cast<const T*>(field);
+        return out.str();
+    }
+
+    static bool from_string(void* field, const char* text, size_t length)
+    {
+        std::istringstream in(std::string(text, length));
+        T value;
+
+        if (!(in >> value) || !(in >> std::ws).eof())
+            return false;
+
+        *static_cast<T*>(field) = value;
+        return true;
+    }
+
+    static field_descriptor::compare_function compare_ptr(std::true_type)
+    {
+        return &compare;
+    }
+
+    static field_descriptor::hash_function hash_ptr(std::true_type)
+    {
+        return &hash;
+    }
+
+    static field_descriptor::to_string_function to_string_ptr(
+        std::true_type)
+    {
+        return &to_string;
+    }
+
+    static field_descriptor::from_string_function from_string_ptr(
+        std::true_type)
+    {
+        return &from_string;
+    }
+
+    static field_descriptor::compare_function compare_ptr(std::false_type)
+    {
+        return 0;
+    }
+
+    static field_descriptor::hash_function hash_ptr(std::false_type)
+    {
+        return 0;
+    }
+
+    static field_descriptor::to_string_function to_string_ptr(
+        std::false_type)
+    {
+        return 0;
+    }
+
+    static field_descriptor::from_string_function from_string_ptr(
+        std::false_type)
+    {
+        return 0;
+    }
+};
+
+/**
+ * Strings are parsed verbatim instead of up to the first blank.
+ */
+template <>
+inline bool field_operations<std::string>::from_string(void* field,
+    const char* text, size_t length)
+{
+    static_cast<std::string*>(field)->assign(text, length);
+    return true;
+}
+
+template <typename S, unsigned int I>
+field_descriptor make_field_descriptor()
+{
+    typedef typename type_at<I, typename S::field_types>::type T;
+    typedef field_operations<T> ops;
+
+    const field_descriptor descriptor = {
+        I,
+        S::get_field_name(I),
+        S::get_type_name(I),
+        S::get_field_offset(I),
+        sizeof(T),
+        alignof(T),
+        type_tag_of<T>::value,
+        ops::compare_ptr(std::integral_constant<bool,
+            has_less<T>::value>()),
+        ops::hash_ptr(std::integral_constant<bool,
+            has_hash<T>::value>()),
+        ops::to_string_ptr(std::integral_constant<bool,
+            has_output<T>::value>()),
+        ops::from_string_ptr(std::integral_constant<bool,
+            has_input<T>::value>())
+    };
+
+    return descriptor;
+}
+
+template <typename S, unsigned int... Is>
+const field_descriptor* get_field_descriptors(index_list<Is...>)
+{
+    static const field_descriptor descriptors[] = {
+        make_field_descriptor<S, Is>()... };
+    return descriptors;
+}
+
+}
+
+/**
+ * Table of the field descriptors of the struct S, indexed by field index.
+ */
+template <typename S>
+const field_descriptor* get_field_descriptors()
+{
+    return detail::get_field_descriptors<S>(
+        typename make_index_list<S::num_fields>::type());
+}
+
+template <typename S>
+const struct_descriptor& get_struct_descriptor()
+{
+    static const struct_descriptor descriptor = {
+        S::get_struct_name(),
+        sizeof(S),
+        alignof(S),
+        S::num_fields,
+        get_field_descriptors<S>(),
+        static_cast<struct_descriptor::find_function>(
+            &S::try_get_field_index)
+    };
+
+    return descriptor;
+}
+
+}
@@ -22,6 +22,18 @@
 #include <ex3/exceptions.hpp>
 #include <ex3/pretty.hpp>
 
+#include <boost/throw_exception.hpp>
+
+/**
+ * Throw an f1d exception. Defining F1D_NO_STACKTRACE skips capturing
+ * the stack trace in every throw, keeping only the source location.
+ */
+#ifdef F1D_NO_STACKTRACE
+#define F1D_THROW(ex) BOOST_THROW_EXCEPTION(ex)
+#else
+#define F1D_THROW(ex) EX3_THROW(ex)
+#endif
+
 namespace f1d {
 
 typedef ex3::pretty_container<
@@ -57,6 +69,21 @@ typedef boost::error_info<
     pretty_string_vector
     > field_names;
 
+typedef boost::error_info<
+    struct tag_buffer_size,
+    size_t
+    > buffer_size;
+
+typedef boost::error_info<
+    struct tag_batch_size,
+    size_t
+    > batch_size;
+
+typedef boost::error_info<
+    struct tag_header_field,
+    std::string
+    > header_field;
+
 class f1d_exception :
     public ex3::exception_base
 {
@@ -92,4 +119,41 @@ class not_found_exception :
 {
 };
 
+class buffer_overflow_exception :
+    public f1d_exception
+{
+};
+
+class io_exception :
+    public f1d_exception
+{
+};
+
+class format_exception :
+    public f1d_exception
+{
+};
+
+class size_mismatch_exception :
+    public f1d_exception
+{
+};
+
+/**
+ * Error codes returned by the non-throwing try_* methods, each one
+ * matching the exception thrown by the equivalent throwing method.
+ */
+enum error_code
+{
+    no_error = 0,
+    not_initialized_error,
+    not_finished_error,
+    already_finished_error,
+    not_set_error,
+    already_set_error,
+    not_found_error,
+    buffer_overflow_error,
+    size_mismatch_error
+};
+
 }
\ No newline at end of file
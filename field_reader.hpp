@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "hash.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace f1d {
+
+namespace detail {
+
+/**
+ * Reads the field selected by a field wrapper from the elements of a
+ * container. The default implementation finds the column of an SoA
+ * container.
+ */
+template <typename Field, typename Container>
+class field_reader
+{
+private:
+
+    typedef typename Field::value_type value_type;
+
+    struct column_finder
+    {
+        const value_type* data;
+
+        column_finder() :
+            data(0)
+        {
+        }
+
+        template <unsigned int I, typename S, typename V>
+        void operator ()(const V& column)
+        {
+            find(column, std::integral_constant<bool, I == Field::index>());
+        }
+
+        template <typename V>
+        void find(const V& column, std::true_type)
+        {
+            data = column.data();
+        }
+
+        template <typename V>
+        void find(const V&, std::false_type)
+        {
+        }
+    };
+
+    const value_type* _data;
+
+public:
+
+    explicit field_reader(const Container& c)
+    {
+        column_finder f;
+        c.capply(f);
+        _data = f.data;
+    }
+
+    const value_type& operator ()(size_t i) const
+    {
+        return _data[i];
+    }
+};
+
+template <typename Field, typename S, typename A>
+class field_reader<Field, std::vector<S, A> >
+{
+private:
+
+    const S* _data;
+
+public:
+
+    explicit field_reader(const std::vector<S, A>& v) :
+        _data(v.data())
+    {
+    }
+
+    const typename Field::value_type& operator ()(size_t i) const
+    {
+        return field_at<S, Field::index>(_data[i]);
+    }
+};
+
+}
+
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "exceptions.hpp"
+#include "lookup.hpp"
+#include "type_list.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace f1d {
+
+namespace detail {
+
+inline constexpr size_t size_sum()
+{
+    return 0;
+}
+
+template <typename... Ts>
+constexpr size_t size_sum(size_t first, Ts... rest)
+{
+    return first + size_sum(rest...);
+}
+
+/**
+ * Number of hashes in [first, last) smaller than hash. The ranges are
+ * split in halves so the recursion depth stays logarithmic in the number
+ * of fields.
+ */
+inline constexpr unsigned int hashes_below(const name_hash_t* hashes,
+    unsigned int first, unsigned int last, name_hash_t hash)
+{
+    return last - first == 1 ? (hashes[first] < hash ? 1 : 0) :
+        hashes_below(hashes, first, first + (last - first) / 2, hash) +
+        hashes_below(hashes, first + (last - first) / 2, last, hash);
+}
+
+/**
+ * Whether the hashes in [first, last) are strictly increasing.
+ */
+inline constexpr bool hashes_increasing(const name_hash_t* hashes,
+    unsigned int first, unsigned int last)
+{
+    return last - first < 2 ? true : last - first == 2 ?
+        hashes[first] < hashes[first + 1] :
+        hashes_increasing(hashes, first, first + (last - first) / 2 + 1) &&
+        hashes_increasing(hashes, first + (last - first) / 2, last);
+}
+
+/**
+ * a, unless it is the not found value n.
+ */
+inline constexpr unsigned int first_found(unsigned int a, unsigned int b,
+    unsigned int n)
+{
+    return a != n ? a : b;
+}
+
+/**
+ * Index in [first, last) of the given rank, or n if there is none.
+ */
+inline constexpr unsigned int find_rank(const unsigned int* ranks,
+    unsigned int n, unsigned int first, unsigned int last, unsigned int rank)
+{
+    return last - first == 1 ? (ranks[first] == rank ? first : n) :
+        first_found(
+            find_rank(ranks, n, first, first + (last - first) / 2, rank),
+            find_rank(ranks, n, first + (last - first) / 2, last, rank), n);
+}
+
+template <typename Meta>
+struct meta_wrapper
+{
+    typedef typename Meta::wrapper_type type;
+};
+
+template <>
+struct meta_wrapper<void>
+{
+    typedef void type;
+};
+
+}
+
+template <typename Metas>
+class field_table;
+
+/**
+ * Metadata of a struct generated by the variadic backend, derived from the
+ * list of its field descriptors instead of one preprocessor expansion per
+ * property. Each descriptor provides the index, value type, wrapper type,
+ * name, type name and name hash of its field, and reaches the field of an
+ * object through ref and offset.
+ */
+template <typename... Ms>
+class field_table<type_list<Ms...> >
+{
+private:
+
+    template <typename M, typename S, typename O, typename Functor>
+    static void visit_one(O& obj, Functor& f)
+    {
+        f.template operator ()<M::index, S>(M::ref(obj));
+    }
+
+public:
+
+    typedef type_list<typename Ms::value_type...> value_types;
+
+    static const unsigned int size = sizeof...(Ms);
+
+    static const size_t packed_size =
+        detail::size_sum(sizeof(typename Ms::value_type)...);
+
+    template <unsigned int I>
+    struct value_type
+    {
+        typedef typename type_at<I, value_types>::type type;
+    };
+
+    template <unsigned int I>
+    struct wrapper_type
+    {
+        typedef typename detail::meta_wrapper<
+            typename type_at<I, type_list<Ms...> >::type>::type type;
+    };
+
+    /**
+     * Metadata arrays of the struct S, each followed by a sentinel.
+     */
+    template <typename S>
+    struct metadata
+    {
+        static constexpr const char* field_names[] = { Ms::name()..., "" };
+        static constexpr const char* type_names[] = {
+            Ms::type_name()..., "" };
+        static constexpr size_t type_sizes[] = {
+            sizeof(typename Ms::value_type)..., 0 };
+        static constexpr size_t field_alignments[] = {
+            alignof(typename Ms::value_type)..., 0 };
+        static constexpr size_t field_offsets[] = {
+            Ms::template offset<S>()..., 0 };
+    };
+
+    /**
+     * Field name hashes in declaration order, followed by a sentinel.
+     */
+    static constexpr name_hash_t hashes[] = { Ms::name_hash()..., 0 };
+
+    /**
+     * Position of each field name hash in ascending order.
+     */
+    static constexpr unsigned int hash_ranks[] = {
+        detail::hashes_below(hashes, 0, size, Ms::name_hash())... };
+
+    /**
+     * Field indices sorted by the hashes of their names, so find can
+     * binary search them.
+     */
+    static constexpr unsigned int sorted_indices[] = {
+        detail::find_rank(hash_ranks, size, 0, size, Ms::index)... };
+
+    static constexpr name_hash_t sorted_hashes[] = {
+        hashes[sorted_indices[Ms::index]]... };
+
+    /**
+     * Equal hashes share a rank and leave the next one to the sentinel,
+     * so the sorted hashes are only strictly increasing if the names are
+     * unique and their hashes do not collide.
+     */
+    static_assert(detail::hashes_increasing(sorted_hashes, 0, size),
+        "field names must be unique and their hashes must not collide");
+
+    static error_code find(const char* name, size_t length,
+        unsigned int& index)
+    {
+        static const size_t lengths[] = { Ms::name_length()... };
+        static const char* const field_names[] = { Ms::name()... };
+
+        const name_hash_t hash = name_hash(name, length);
+        const name_hash_t* it = std::lower_bound(sorted_hashes,
+            sorted_hashes + size, hash);
+
+        if (it == sorted_hashes + size || *it != hash)
+            return not_found_error;
+
+        const unsigned int i = sorted_indices[it - sorted_hashes];
+
+        if (!name_equals(name, length, field_names[i], lengths[i]))
+            return not_found_error;
+
+        index = i;
+        return no_error;
+    }
+
+    /**
+     * Call the functor on the field of obj with the given index through a
+     * table of function pointers.
+     */
+    template <typename S, typename O, typename Functor>
+    static error_code visit(O& obj, unsigned int index, Functor& f)
+    {
+        typedef void (*visitor_type)(O&, Functor&);
+
+        static const visitor_type visitors[] = {
+            &visit_one<Ms, S, O, Functor>... };
+
+        if (index >= size)
+            return not_found_error;
+
+        visitors[index](obj, f);
+        return no_error;
+    }
+
+    /**
+     * Call the functor on each field of obj in declaration order, as in
+     * f.template operator ()<I, S>(field).
+     */
+    template <typename S, typename O, typename Functor>
+    static void apply(O& obj, Functor& f)
+    {
+        const int expand[] = { 0,
+            (static_cast<void>(
+                f.template operator ()<Ms::index, S>(Ms::ref(obj))), 0)... };
+        (void)expand;
+    }
+};
+
+template <typename... Ms>
+const unsigned int field_table<type_list<Ms...> >::size;
+
+template <typename... Ms>
+const size_t field_table<type_list<Ms...> >::packed_size;
+
+template <typename... Ms>
+constexpr name_hash_t field_table<type_list<Ms...> >::hashes[];
+
+template <typename... Ms>
+constexpr unsigned int field_table<type_list<Ms...> >::hash_ranks[];
+
+template <typename... Ms>
+constexpr unsigned int field_table<type_list<Ms...> >::sorted_indices[];
+
+template <typename... Ms>
+constexpr name_hash_t field_table<type_list<Ms...> >::sorted_hashes[];
+
+template <typename... Ms>
+template <typename S>
+constexpr const char*
+    field_table<type_list<Ms...> >::metadata<S>::field_names[];
+
+template <typename... Ms>
+template <typename S>
+constexpr const char*
+    field_table<type_list<Ms...> >::metadata<S>::type_names[];
+
+template <typename... Ms>
+template <typename S>
+constexpr size_t field_table<type_list<Ms...> >::metadata<S>::type_sizes[];
+
+template <typename... Ms>
+template <typename S>
+constexpr size_t
+    field_table<type_list<Ms...> >::metadata<S>::field_alignments[];
+
+template <typename... Ms>
+template <typename S>
+constexpr size_t
+    field_table<type_list<Ms...> >::metadata<S>::field_offsets[];
+
+}
@@ -19,19 +19,44 @@
 
 #pragma once
 
+#include "batch.hpp"
+#include "compare.hpp"
 #include "exceptions.hpp"
+#include "field_table.hpp"
+#include "hash.hpp"
+#include "lookup.hpp"
+#include "mask.hpp"
+#include "packed.hpp"
+#include "policies.hpp"
+#include "serialize.hpp"
+#include "span.hpp"
+#include "type_list.hpp"
 
 #include <boost/preprocessor/tuple/elem.hpp>
 #include <boost/preprocessor/seq/size.hpp>
 #include <boost/preprocessor/seq/for_each_i.hpp>
 #include <boost/preprocessor/stringize.hpp>
 #include <boost/preprocessor/punctuation/comma.hpp>
+#include <boost/preprocessor/punctuation/comma_if.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <boost/utility/string_view.hpp>
 
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#ifdef F1D_INSTRUMENT
+#include "instrument.hpp"
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define F1D_STRUCT_TYPE_NAME(Name) \
@@ -40,6 +65,15 @@
 #define F1D_STRUCT_FACTORY_NAME(Name) \
     BOOST_PP_CAT(Name, _factory)
 
+#define F1D_STRUCT_BASIC_FACTORY_NAME(Name) \
+    BOOST_PP_CAT(Name, _basic_factory)
+
+#define F1D_STRUCT_BATCH_FACTORY_NAME(Name) \
+    BOOST_PP_CAT(Name, _batch_factory)
+
+#define F1D_STRUCT_BASIC_BATCH_FACTORY_NAME(Name) \
+    BOOST_PP_CAT(Name, _basic_batch_factory)
+
 #define F1D_STRUCT_FULL_TYPE(Namespace, Name) \
     Namespace::F1D_STRUCT_TYPE_NAME(Name)
 
@@ -122,40 +156,218 @@ namespace traits { \
         Namespace, \
         BOOST_PP_TUPLE_ELEM(2, 0, elem))
 
+#define F1D_STRUCT_ASSEMBLE_TLIST(_s, Namespace, i, elem) \
+    BOOST_PP_COMMA_IF(i) F1D_STRUCT_FULL_TYPE(Namespace, \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem))
+
+/**
+ * Accessors of a packed field. Name() counts the access like the field
+ * wrappers, raw_Name() does not and is the path used by the generated
+ * code (apply, serialization, comparison, factory and wrappers).
+ */
+#define F1D_STRUCT_ASSEMBLE_ACCESSOR(StructName, Namespace, Name, i) \
+    inline F1D_STRUCT_FULL_TYPE(Namespace, Name)& Name() \
+    { \
+        F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+        return BOOST_PP_CAT(raw_, Name)(); \
+    } \
+    inline const F1D_STRUCT_FULL_TYPE(Namespace, Name)& Name() const \
+    { \
+        F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+        return BOOST_PP_CAT(raw_, Name)(); \
+    } \
+    inline F1D_STRUCT_FULL_TYPE(Namespace, Name)& BOOST_PP_CAT(raw_, Name)() \
+    { \
+        return f1d::packed_get<layout_type::slot(i)>(_fields); \
+    } \
+    inline const F1D_STRUCT_FULL_TYPE(Namespace, Name)& \
+        BOOST_PP_CAT(raw_, Name)() const \
+    { \
+        return f1d::packed_get<layout_type::slot(i)>(_fields); \
+    }
+
+#define F1D_STRUCT_ASSEMBLE_ACCESSORS(_s, Data, i, elem) \
+    F1D_STRUCT_ASSEMBLE_ACCESSOR( \
+        BOOST_PP_TUPLE_ELEM(2, 0, Data), \
+        BOOST_PP_TUPLE_ELEM(2, 1, Data), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem), \
+        i)
+
+#define F1D_STRUCT_META_NAME(Name) \
+    BOOST_PP_CAT(Name, _meta)
+
+#define F1D_STRUCT_DECL_META(Type, Name, i, Field, Offset) \
+    typedef Type F1D_STRUCT_TYPE_NAME(Name); \
+    struct BOOST_PP_CAT(Name,_f); \
+    struct F1D_STRUCT_META_NAME(Name) { \
+        static const unsigned int index = i; \
+        typedef F1D_STRUCT_TYPE_NAME(Name) value_type; \
+        typedef BOOST_PP_CAT(Name,_f) wrapper_type; \
+        static constexpr const char* name() { \
+            return BOOST_PP_STRINGIZE(Name); \
+        } \
+        static constexpr size_t name_length() { \
+            return F1D_STRUCT_NAME_LENGTH(Name); \
+        } \
+        static constexpr f1d::name_hash_t name_hash() { \
+            return f1d::static_name_hash(BOOST_PP_STRINGIZE(Name), \
+                F1D_STRUCT_NAME_LENGTH(Name)); \
+        } \
+        static constexpr const char* type_name() { \
+            return BOOST_PP_STRINGIZE(Type); \
+        } \
+        template <typename S> \
+        static value_type& ref(S& obj) { \
+            return Field(obj, Name); \
+        } \
+        template <typename S> \
+        static const value_type& ref(const S& obj) { \
+            return Field(obj, Name); \
+        } \
+        template <typename S> \
+        static constexpr size_t offset() { \
+            return Offset(S, Name, i); \
+        } \
+    };
+
+#define F1D_STRUCT_ASSEMBLE_METAS(_s, what, i, elem) \
+    F1D_STRUCT_DECL_META( \
+        BOOST_PP_TUPLE_ELEM(2, 1, elem), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem), \
+        i, \
+        BOOST_PP_TUPLE_ELEM(2, 0, what), \
+        BOOST_PP_TUPLE_ELEM(2, 1, what))
+
+#define F1D_STRUCT_ASSEMBLE_MLIST(_s, Namespace, i, elem) \
+    BOOST_PP_COMMA_IF(i) Namespace::F1D_STRUCT_META_NAME( \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem))
+
 ///////////////////////////////////////////////////////////////////////////////
 
-#define F1D_STRUCT_ASSEMBLE_SUPER_FIELD(StructName, i, Name) \
+/**
+ * Physical layouts of the generated structs. A layout declares the data
+ * members, accesses a field of an object and computes the offset of a
+ * field. Plain structs hold the fields as public members in declaration
+ * order, packed structs sort them by decreasing alignment and expose them
+ * through accessor methods with the field names.
+ */
+
+#define F1D_LAYOUT_PLAIN_MEMBERS(Name, Fields) \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_FIELDS, types, Fields)
+
+#define F1D_LAYOUT_PLAIN_FIELD(Obj, Name) \
+    (Obj).Name
+
+#define F1D_LAYOUT_PLAIN_OFFSET(StructName, Name, i) \
+    offsetof(StructName, Name)
+
+/**
+ * offsetof is conditionally-supported on structs that are not standard
+ * layout, such as plain structs with std::map fields, but GCC and clang
+ * compute it for them. The warning is ignored in the generated code only.
+ */
+#if defined(__GNUC__)
+#define F1D_IGNORE_OFFSETOF_WARNING_BEGIN() \
+    _Pragma("GCC diagnostic push") \
+    _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")
+#define F1D_IGNORE_OFFSETOF_WARNING_END() \
+    _Pragma("GCC diagnostic pop")
+#else
+#define F1D_IGNORE_OFFSETOF_WARNING_BEGIN()
+#define F1D_IGNORE_OFFSETOF_WARNING_END()
+#endif
+
+#define F1D_LAYOUT_PACKED_MEMBERS(Name, Fields) \
+    typedef f1d::packed_layout<field_types> layout_type; \
+    inline static constexpr size_t get_storage_offset() \
+    { \
+        return offsetof(Name, _fields); \
+    } \
+private: \
+    f1d::packed_storage<layout_type> _fields; \
+public: \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_ACCESSORS, (Name, types), \
+        Fields)
+
+#define F1D_LAYOUT_PACKED_FIELD(Obj, Name) \
+    (Obj).BOOST_PP_CAT(raw_, Name)()
+
+#define F1D_LAYOUT_PACKED_OFFSET(StructName, Name, i) \
+    (StructName::get_storage_offset() + StructName::layout_type::offset(i))
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Count an access to the field at index i of StructName, used by the
+ * field wrappers, the factory setters and visit_field when F1D_INSTRUMENT
+ * is defined. It must be defined the same way in every translation unit.
+ */
+#ifdef F1D_INSTRUMENT
+#define F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+    f1d::count_field_access<StructName>(i);
+#else
+#define F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+    (void)(i);
+#endif
+
+#define F1D_STRUCT_ASSEMBLE_SUPER_FIELD(StructName, Field, i, Name) \
     struct BOOST_PP_CAT(Name,_f) { \
         static const unsigned int index = i; \
+        typedef StructName struct_type; \
         typedef BOOST_PP_CAT(Name,_f) this_type; \
         typedef F1D_STRUCT_TYPE_NAME(Name) value_type; \
         value_type _value; \
-        BOOST_PP_CAT(Name,_f)() : \
+        BOOST_PP_CAT(Name,_f)() noexcept( \
+            std::is_nothrow_default_constructible<value_type>::value) : \
             _value() \
         { \
         } \
-        BOOST_PP_CAT(Name,_f)(const this_type& other) : \
+        BOOST_PP_CAT(Name,_f)(const this_type& other) noexcept( \
+            std::is_nothrow_copy_constructible<value_type>::value) : \
             _value(other._value) \
         { \
         } \
+        BOOST_PP_CAT(Name,_f)(this_type&& other) noexcept( \
+            std::is_nothrow_move_constructible<value_type>::value) : \
+            _value(std::move(other._value)) \
+        { \
+        } \
         BOOST_PP_CAT(Name,_f)(const value_type& value) : \
             _value(value) \
         { \
         } \
+        BOOST_PP_CAT(Name,_f)(value_type&& value) noexcept( \
+            std::is_nothrow_move_constructible<value_type>::value) : \
+            _value(std::move(value)) \
+        { \
+        } \
         BOOST_PP_CAT(Name,_f)(const StructName& obj) : \
-            _value(obj.Name) \
+            _value(Field(obj, Name)) \
         { \
+            F1D_STRUCT_COUNT_ACCESS(StructName, i) \
         } \
-        this_type& operator =(const this_type& other) { \
+        this_type& operator =(const this_type& other) noexcept( \
+            std::is_nothrow_copy_assignable<value_type>::value) { \
             _value = other._value; \
             return *this; \
         } \
+        this_type& operator =(this_type&& other) noexcept( \
+            std::is_nothrow_move_assignable<value_type>::value) { \
+            _value = std::move(other._value); \
+            return *this; \
+        } \
         this_type& operator =(const value_type& value) { \
             _value = value; \
             return *this; \
         } \
+        this_type& operator =(value_type&& value) noexcept( \
+            std::is_nothrow_move_assignable<value_type>::value) { \
+            _value = std::move(value); \
+            return *this; \
+        } \
         this_type& operator =(const StructName& obj) { \
-            _value = obj.Name; \
+            F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+            _value = Field(obj, Name); \
             return *this; \
         } \
         const value_type& get() const { \
@@ -164,73 +376,183 @@ namespace traits { \
         value_type& get() { \
             return _value; \
         } \
-        operator value_type() const { \
+        operator value_type() const & { \
             return get(); \
         } \
-        void operator ()(value_type& value) const { \
+        operator value_type() && { \
+            return std::move(_value); \
+        } \
+        void operator ()(value_type& value) const & { \
             value = _value; \
         } \
-        void operator ()(StructName& obj) const { \
-            obj.Name = _value; \
+        void operator ()(value_type& value) && { \
+            value = std::move(_value); \
         } \
-        void operator ()(F1D_STRUCT_FACTORY_NAME(StructName)& obj) const { \
+        void operator ()(StructName& obj) const & { \
+            F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+            Field(obj, Name) = _value; \
+        } \
+        void operator ()(StructName& obj) && { \
+            F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+            Field(obj, Name) = std::move(_value); \
+        } \
+        template <typename Policy> \
+        void operator ()( \
+            F1D_STRUCT_BASIC_FACTORY_NAME(StructName)<Policy>& obj) \
+            const & { \
             obj.BOOST_PP_CAT(set_, Name)(_value); \
         } \
+        template <typename Policy> \
+        void operator ()( \
+            F1D_STRUCT_BASIC_FACTORY_NAME(StructName)<Policy>& obj) && { \
+            obj.BOOST_PP_CAT(set_, Name)(std::move(_value)); \
+        } \
+        void set_member(StructName& obj) const & { \
+            F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+            Field(obj, Name) = _value; \
+        } \
+        void set_member(StructName& obj) && { \
+            F1D_STRUCT_COUNT_ACCESS(StructName, i) \
+            Field(obj, Name) = std::move(_value); \
+        } \
         template <typename T> \
-        void set_member(T& obj) const { \
+        void set_member(T& obj) const & { \
             obj.Name = _value; \
         } \
+        template <typename T> \
+        void set_member(T& obj) && { \
+            obj.Name = std::move(_value); \
+        } \
     };
 
-#define F1D_STRUCT_ASSEMBLE_SUPER_FIELDS(_s, StructName, i, elem) \
+#define F1D_STRUCT_ASSEMBLE_SUPER_FIELDS(_s, what, i, elem) \
     F1D_STRUCT_ASSEMBLE_SUPER_FIELD( \
-        StructName, \
+        BOOST_PP_TUPLE_ELEM(2, 0, what), \
+        BOOST_PP_TUPLE_ELEM(2, 1, what), \
         i, \
         BOOST_PP_TUPLE_ELEM(2, 0, elem))
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#define F1D_STRUCT_DECL_INIT(Type, Name, Idx) \
+#define F1D_STRUCT_DECL_INIT(Type, Field, Name, Idx) \
+    inline f1d::error_code BOOST_PP_CAT(try_set_, Name)(const Type& value) \
+    { \
+        const f1d::error_code error = try_mark(Idx); \
+        if (error != f1d::no_error) \
+            return error; \
+        Field(_obj, Name) = value; \
+        return f1d::no_error; \
+    } \
+    inline f1d::error_code BOOST_PP_CAT(try_set_, Name)(Type&& value) \
+    { \
+        const f1d::error_code error = try_mark(Idx); \
+        if (error != f1d::no_error) \
+            return error; \
+        Field(_obj, Name) = std::move(value); \
+        return f1d::no_error; \
+    } \
+    template <typename... Args> \
+    inline typename std::enable_if< \
+        std::is_constructible<Type, Args&&...>::value, \
+        f1d::error_code>::type \
+    BOOST_PP_CAT(try_emplace_, Name)(Args&&... args) \
+    { \
+        Type value(std::forward<Args>(args)...); \
+        const f1d::error_code error = try_mark(Idx); \
+        if (error != f1d::no_error) \
+            return error; \
+        Field(_obj, Name) = std::move(value); \
+        return f1d::no_error; \
+    } \
     inline void BOOST_PP_CAT(set_, Name)(const Type& value) \
     { \
-        if (!_begun) { \
-            EX3_THROW(f1d::not_intialized_exception() \
-                << f1d::struct_name(get_struct_name())); \
+        const f1d::error_code error = BOOST_PP_CAT(try_set_, Name)(value); \
+        if (error != f1d::no_error) { \
+            raise(error, Idx, BOOST_PP_STRINGIZE(Name)); \
         } \
-        if (_ended) { \
-            EX3_THROW(f1d::already_finished_exception() \
-                << f1d::struct_name(get_struct_name())); \
+    } \
+    inline void BOOST_PP_CAT(set_, Name)(Type&& value) \
+    { \
+        const f1d::error_code error = BOOST_PP_CAT(try_set_, Name)( \
+            std::move(value)); \
+        if (error != f1d::no_error) { \
+            raise(error, Idx, BOOST_PP_STRINGIZE(Name)); \
         } \
-        if (_set_fields[Idx]) { \
-            EX3_THROW(f1d::already_set_exception() \
-                << f1d::struct_name(get_struct_name()) \
-                << f1d::field_index(Idx) \
-                << f1d::field_name(BOOST_PP_STRINGIZE(Name))); \
+    } \
+    template <typename... Args> \
+    inline typename std::enable_if< \
+        std::is_constructible<Type, Args&&...>::value>::type \
+    BOOST_PP_CAT(emplace_, Name)(Args&&... args) \
+    { \
+        const f1d::error_code error = BOOST_PP_CAT(try_emplace_, Name)( \
+            std::forward<Args>(args)...); \
+        if (error != f1d::no_error) { \
+            raise(error, Idx, BOOST_PP_STRINGIZE(Name)); \
         } \
-        _set_fields[Idx] = true; \
-        _obj.Name = value; \
     } \
     inline const Type& BOOST_PP_CAT(get_, Name)() \
     { \
-        if (!_begun) { \
-            EX3_THROW(f1d::not_intialized_exception() \
-                << f1d::struct_name(get_struct_name())); \
-        } \
-        if (!_set_fields[Idx]) { \
-            EX3_THROW(f1d::not_set_exception() \
-                << f1d::struct_name(get_struct_name()) \
-                << f1d::field_index(Idx) \
-                << f1d::field_name(BOOST_PP_STRINGIZE(Name))); \
+        if (Policy::checked) { \
+            if (!_begun) { \
+                F1D_THROW(f1d::not_intialized_exception() \
+                    << f1d::struct_name(get_struct_name())); \
+            } \
+            if (!_set_fields.test(Idx)) { \
+                F1D_THROW(f1d::not_set_exception() \
+                    << f1d::struct_name(get_struct_name()) \
+                    << f1d::field_index(Idx) \
+                    << f1d::field_name(BOOST_PP_STRINGIZE(Name))); \
+            } \
         } \
-        return _obj.Name; \
+        count_access(Idx); \
+        return Field(_obj, Name); \
     }
 
-#define F1D_STRUCT_ASSEMBLE_INIT(Namespace, Name, Idx) \
+#define F1D_STRUCT_ASSEMBLE_INIT(Namespace, Field, Name, Idx) \
     F1D_STRUCT_DECL_INIT( \
-        F1D_STRUCT_FULL_TYPE(Namespace, Name), Name, Idx)
+        F1D_STRUCT_FULL_TYPE(Namespace, Name), Field, Name, Idx)
 
-#define F1D_STRUCT_ASSEMBLE_INITS(_s, Namespace, i, elem) \
+#define F1D_STRUCT_ASSEMBLE_INITS(_s, what, i, elem) \
     F1D_STRUCT_ASSEMBLE_INIT( \
+        BOOST_PP_TUPLE_ELEM(2, 0, what), \
+        BOOST_PP_TUPLE_ELEM(2, 1, what), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem), \
+        i)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_STRUCT_DECL_BATCH_INIT(Type, Name, Idx) \
+    inline f1d::error_code BOOST_PP_CAT(try_set_, Name)( \
+        f1d::span<const Type> values) \
+    { \
+        if (Policy::checked) { \
+            if (!_begun) \
+                return f1d::not_initialized_error; \
+            if (_ended) \
+                return f1d::already_finished_error; \
+            if (_set_fields.test(Idx)) \
+                return f1d::already_set_error; \
+            if (values.size() != _size) \
+                return f1d::size_mismatch_error; \
+            _set_fields.set(Idx); \
+        } \
+        _columns[Idx] = values.data(); \
+        return f1d::no_error; \
+    } \
+    inline void BOOST_PP_CAT(set_, Name)(f1d::span<const Type> values) \
+    { \
+        const f1d::error_code error = BOOST_PP_CAT(try_set_, Name)(values); \
+        if (error != f1d::no_error) { \
+            raise(error, Idx, BOOST_PP_STRINGIZE(Name)); \
+        } \
+    }
+
+#define F1D_STRUCT_ASSEMBLE_BATCH_INIT(Namespace, Name, Idx) \
+    F1D_STRUCT_DECL_BATCH_INIT( \
+        F1D_STRUCT_FULL_TYPE(Namespace, Name), Name, Idx)
+
+#define F1D_STRUCT_ASSEMBLE_BATCH_INITS(_s, Namespace, i, elem) \
+    F1D_STRUCT_ASSEMBLE_BATCH_INIT( \
         Namespace, \
         BOOST_PP_TUPLE_ELEM(2, 0, elem), \
         i)
@@ -255,25 +577,67 @@ namespace traits { \
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#define F1D_STRUCT_NAME_LENGTH(Name) \
+    (sizeof(BOOST_PP_STRINGIZE(Name)) - 1)
+
 #define F1D_STRUCT_ASSEMBLE_SNAME(Name, i) \
-    if (name.compare(BOOST_PP_STRINGIZE(Name)) == 0) \
-        return i;
+    case f1d::static_name_hash(BOOST_PP_STRINGIZE(Name), \
+        F1D_STRUCT_NAME_LENGTH(Name)): \
+        if (f1d::name_equals(name, length, BOOST_PP_STRINGIZE(Name), \
+            F1D_STRUCT_NAME_LENGTH(Name))) { \
+            index = i; \
+            return f1d::no_error; \
+        } \
+        break;
 
 #define F1D_STRUCT_ASSEMBLE_SNAMES(_s, nothing, i, elem) \
     F1D_STRUCT_ASSEMBLE_SNAME( \
         BOOST_PP_TUPLE_ELEM(2, 0, elem), \
         i)
 
+#if __cplusplus >= 201703L
+#define F1D_STRUCT_STD_STRING_VIEW_INDEX() \
+    inline static f1d::error_code try_get_field_index( \
+        std::string_view name, unsigned int& index) \
+    { \
+        return try_get_field_index(name.data(), name.size(), index); \
+    } \
+    inline static unsigned int get_field_index(std::string_view name) \
+    { \
+        return get_field_index(name.data(), name.size()); \
+    }
+#else
+#define F1D_STRUCT_STD_STRING_VIEW_INDEX()
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
-#define F1D_STRUCT_ASSEMBLE_APPLY(StructName, StructVal, Funct, Name, i) \
-    Funct.template operator ()<i, StructName>((StructVal).Name);
+#define F1D_STRUCT_ASSEMBLE_APPLY(StructName, StructVal, Funct, Field, \
+    Name, i) \
+    Funct.template operator ()<i, StructName>(Field(StructVal, Name));
 
 #define F1D_STRUCT_ASSEMBLE_APPLYS(_s, what, i, elem) \
     F1D_STRUCT_ASSEMBLE_APPLY( \
-        BOOST_PP_TUPLE_ELEM(3, 0, what), \
-        BOOST_PP_TUPLE_ELEM(3, 1, what), \
-        BOOST_PP_TUPLE_ELEM(3, 2, what), \
+        BOOST_PP_TUPLE_ELEM(4, 0, what), \
+        BOOST_PP_TUPLE_ELEM(4, 1, what), \
+        BOOST_PP_TUPLE_ELEM(4, 2, what), \
+        BOOST_PP_TUPLE_ELEM(4, 3, what), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem), \
+        i)
+
+#define F1D_STRUCT_ASSEMBLE_VISIT(StructName, StructVal, Funct, Field, \
+    Name, i) \
+    case i: \
+        F1D_STRUCT_ASSEMBLE_APPLY(StructName, StructVal, Funct, Field, \
+            Name, i) \
+        return f1d::no_error;
+
+#define F1D_STRUCT_ASSEMBLE_VISITS(_s, what, i, elem) \
+    F1D_STRUCT_ASSEMBLE_VISIT( \
+        BOOST_PP_TUPLE_ELEM(4, 0, what), \
+        BOOST_PP_TUPLE_ELEM(4, 1, what), \
+        BOOST_PP_TUPLE_ELEM(4, 2, what), \
+        BOOST_PP_TUPLE_ELEM(4, 3, what), \
         BOOST_PP_TUPLE_ELEM(2, 0, elem), \
         i)
 
@@ -286,191 +650,626 @@ namespace traits { \
     F1D_STRUCT_ASSEMBLE_TSIZE( \
         BOOST_PP_TUPLE_ELEM(2, 1, elem))
 
+#define F1D_STRUCT_ASSEMBLE_TALIGN(Type) \
+    alignof(Type) BOOST_PP_COMMA()
+
+#define F1D_STRUCT_ASSEMBLE_TALIGNS(_s, nothing, i, elem) \
+    F1D_STRUCT_ASSEMBLE_TALIGN( \
+        BOOST_PP_TUPLE_ELEM(2, 1, elem))
+
+#define F1D_STRUCT_ASSEMBLE_FOFFSET(StructName, Offset, Name, i) \
+    Offset(StructName, Name, i) BOOST_PP_COMMA()
+
+#define F1D_STRUCT_ASSEMBLE_FOFFSETS(_s, what, i, elem) \
+    F1D_STRUCT_ASSEMBLE_FOFFSET( \
+        BOOST_PP_TUPLE_ELEM(2, 0, what), \
+        BOOST_PP_TUPLE_ELEM(2, 1, what), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem), \
+        i)
+
+#define F1D_STRUCT_ASSEMBLE_PSIZE(Type) \
+    + sizeof(Type)
+
+#define F1D_STRUCT_ASSEMBLE_PSIZES(_s, nothing, i, elem) \
+    F1D_STRUCT_ASSEMBLE_PSIZE( \
+        BOOST_PP_TUPLE_ELEM(2, 1, elem))
+
 ///////////////////////////////////////////////////////////////////////////////
 
-#define F1D_STRUCT_MAKE_S1(Name, NF, Fields, Traits) \
-namespace types { \
-    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_TYPES, 0, Fields) \
-} \
-struct Name { \
-    static const unsigned int num_fields = NF; \
-    inline static unsigned int get_num_fields() \
+/**
+ * Members shared by both backends, built on the metadata arrays, the name
+ * lookup and the apply methods provided by each backend. The arrays and
+ * their accessors are constexpr, so they can be used in static_asserts.
+ */
+#define F1D_STRUCT_ASSEMBLE_METHODS(Name, NF) \
+    inline static constexpr unsigned int get_num_fields() \
     { \
         return num_fields; \
     } \
-    inline static const char* get_struct_name() \
+    inline static constexpr const char* get_struct_name() \
     { \
         return BOOST_PP_STRINGIZE(Name); \
     } \
-    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_FIELDS, types, Fields) \
-    inline static const char** get_field_names() \
-    { \
-        static const char* field_names[] = { \
-            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_NAMES, 0, Fields) \
-            "" \
-        }; \
-        return field_names; \
-    } \
-    inline static const char* get_field_name(unsigned int index) \
+    inline static unsigned int check_field_index(unsigned int index) \
     { \
         if (index >= NF) { \
-            EX3_THROW(f1d::not_found_exception() \
+            F1D_THROW(f1d::not_found_exception() \
                 << f1d::struct_name(get_struct_name()) \
                 << f1d::field_index(index)); \
         } \
-        static const char** field_names = get_field_names(); \
-        return field_names[index]; \
+        return index; \
     } \
-    inline static const char** get_type_names() \
+    inline static constexpr const char* const* get_field_names() \
     { \
-        static const char* type_names[] = { \
-            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_TNAMES, 0, Fields) \
-            "" \
-        }; \
-        return type_names; \
+        return metadata::field_names; \
     } \
-    inline static const char* get_type_name(unsigned int index) \
+    inline static constexpr const char* const* get_type_names() \
     { \
-        if (index >= NF) { \
-            EX3_THROW(f1d::not_found_exception() \
-                << f1d::struct_name(get_struct_name()) \
-                << f1d::field_index(index)); \
-        } \
-        static const char** type_names = get_type_names(); \
-        return type_names[index]; \
+        return metadata::type_names; \
     } \
-    inline static unsigned int get_field_index(const std::string& name) \
+    inline static constexpr const size_t* get_type_sizes() \
     { \
-        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_SNAMES, 0, Fields) \
-        EX3_THROW(f1d::not_found_exception() \
-            << f1d::struct_name(get_struct_name()) \
-            << f1d::field_name(name)); \
+        return metadata::type_sizes; \
     } \
-    inline static const size_t* get_type_sizes() \
+    inline static constexpr const size_t* get_field_alignments() \
     { \
-        static const size_t type_sizes[] = { \
-            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_TSIZES, 0, Fields) \
-            0 \
-        }; \
-        return type_sizes; \
+        return metadata::field_alignments; \
     } \
-    inline static size_t get_type_size(unsigned int index) \
+    inline static constexpr const size_t* get_field_offsets() \
     { \
-        if (index >= NF) { \
-            EX3_THROW(f1d::not_found_exception() \
-                << f1d::struct_name(get_struct_name()) \
-                << f1d::field_index(index)); \
-        } \
-        static const size_t* type_sizes = get_type_sizes(); \
-        return type_sizes[index]; \
+        return metadata::field_offsets; \
+    } \
+    template <typename S> \
+    friend typename std::enable_if<std::is_same<S, Name>::value, \
+        size_t>::type hash_value(const S& obj) \
+    { \
+        return f1d::hash_struct(obj); \
+    } \
+    template <typename S> \
+    friend typename std::enable_if<std::is_same<S, Name>::value, \
+        bool>::type operator ==(const S& a, const S& b) \
+    { \
+        return f1d::struct_equal(a, b); \
+    } \
+    template <typename S> \
+    friend typename std::enable_if<std::is_same<S, Name>::value, \
+        bool>::type operator !=(const S& a, const S& b) \
+    { \
+        return !f1d::struct_equal(a, b); \
+    } \
+    template <typename S> \
+    friend typename std::enable_if<std::is_same<S, Name>::value, \
+        bool>::type operator <(const S& a, const S& b) \
+    { \
+        return f1d::struct_less(a, b); \
     } \
     template <typename Functor> \
-    void apply(Functor& f) \
+    f1d::error_code try_visit_field(unsigned int index, Functor& f) \
     { \
-        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, (Name, *this, f), \
-            Fields) \
+        F1D_STRUCT_COUNT_ACCESS(Name, index) \
+        return dispatch_field(*this, index, f); \
     } \
     template <typename Functor> \
-    void capply(Functor& f) const \
+    f1d::error_code try_cvisit_field(unsigned int index, Functor& f) const \
     { \
-        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, (Name, *this, f), \
-            Fields) \
+        F1D_STRUCT_COUNT_ACCESS(Name, index) \
+        return dispatch_field(*this, index, f); \
     } \
     template <typename Functor> \
-    void apply(const Functor& f) \
+    f1d::error_code try_visit_field(unsigned int index, const Functor& f) \
     { \
-        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, (Name, *this, f), \
-            Fields) \
+        F1D_STRUCT_COUNT_ACCESS(Name, index) \
+        return dispatch_field(*this, index, f); \
     } \
     template <typename Functor> \
-    void capply(const Functor& f) const \
+    f1d::error_code try_cvisit_field(unsigned int index, \
+        const Functor& f) const \
     { \
-        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, (Name, *this, f), \
-            Fields) \
+        F1D_STRUCT_COUNT_ACCESS(Name, index) \
+        return dispatch_field(*this, index, f); \
     } \
-}; \
-class F1D_STRUCT_FACTORY_NAME(Name) { \
+    template <typename Functor> \
+    void visit_field(unsigned int index, Functor& f) \
+    { \
+        if (try_visit_field(index, f) != f1d::no_error) \
+            check_field_index(index); \
+    } \
+    template <typename Functor> \
+    void cvisit_field(unsigned int index, Functor& f) const \
+    { \
+        if (try_cvisit_field(index, f) != f1d::no_error) \
+            check_field_index(index); \
+    } \
+    template <typename Functor> \
+    void visit_field(unsigned int index, const Functor& f) \
+    { \
+        if (try_visit_field(index, f) != f1d::no_error) \
+            check_field_index(index); \
+    } \
+    template <typename Functor> \
+    void cvisit_field(unsigned int index, const Functor& f) const \
+    { \
+        if (try_cvisit_field(index, f) != f1d::no_error) \
+            check_field_index(index); \
+    } \
+    inline static constexpr const char* get_field_name(unsigned int index) \
+    { \
+        return get_field_names()[ \
+            index < NF ? index : check_field_index(index)]; \
+    } \
+    inline static constexpr const char* get_type_name(unsigned int index) \
+    { \
+        return get_type_names()[ \
+            index < NF ? index : check_field_index(index)]; \
+    } \
+    inline static f1d::error_code try_get_field_index(const char* name, \
+        unsigned int& index) \
+    { \
+        return try_get_field_index(name, std::strlen(name), index); \
+    } \
+    inline static f1d::error_code try_get_field_index( \
+        const std::string& name, unsigned int& index) \
+    { \
+        return try_get_field_index(name.data(), name.size(), index); \
+    } \
+    inline static f1d::error_code try_get_field_index( \
+        boost::string_view name, unsigned int& index) \
+    { \
+        return try_get_field_index(name.data(), name.size(), index); \
+    } \
+    inline static unsigned int get_field_index(const char* name, \
+        size_t length) \
+    { \
+        unsigned int index; \
+        if (try_get_field_index(name, length, index) != f1d::no_error) { \
+            F1D_THROW(f1d::not_found_exception() \
+                << f1d::struct_name(get_struct_name()) \
+                << f1d::field_name(std::string(name, length))); \
+        } \
+        return index; \
+    } \
+    inline static unsigned int get_field_index(const char* name) \
+    { \
+        return get_field_index(name, std::strlen(name)); \
+    } \
+    inline static unsigned int get_field_index(const std::string& name) \
+    { \
+        return get_field_index(name.data(), name.size()); \
+    } \
+    inline static unsigned int get_field_index(boost::string_view name) \
+    { \
+        return get_field_index(name.data(), name.size()); \
+    } \
+    F1D_STRUCT_STD_STRING_VIEW_INDEX() \
+    inline static constexpr size_t get_type_size(unsigned int index) \
+    { \
+        return get_type_sizes()[ \
+            index < NF ? index : check_field_index(index)]; \
+    } \
+    inline static constexpr size_t get_field_alignment(unsigned int index) \
+    { \
+        return get_field_alignments()[ \
+            index < NF ? index : check_field_index(index)]; \
+    } \
+    inline static constexpr size_t get_field_offset(unsigned int index) \
+    { \
+        return get_field_offsets()[ \
+            index < NF ? index : check_field_index(index)]; \
+    } \
+    template <typename S = Name> \
+    inline size_t get_serialized_size() const \
+    { \
+        return f1d::serialized_size(static_cast<const S&>(*this)); \
+    } \
+    template <typename S = Name> \
+    inline f1d::error_code try_serialize(void* buffer, size_t size, \
+        size_t& written) const \
+    { \
+        return f1d::try_serialize(static_cast<const S&>(*this), buffer, \
+            size, written); \
+    } \
+    template <typename S = Name> \
+    inline size_t serialize(void* buffer, size_t size) const \
+    { \
+        return f1d::serialize(static_cast<const S&>(*this), buffer, size); \
+    } \
+    template <typename S = Name> \
+    inline f1d::error_code try_deserialize(const void* buffer, size_t size, \
+        size_t& read) \
+    { \
+        return f1d::try_deserialize(static_cast<S&>(*this), buffer, size, \
+            read); \
+    } \
+    template <typename S = Name> \
+    inline size_t deserialize(const void* buffer, size_t size) \
+    { \
+        return f1d::deserialize(static_cast<S&>(*this), buffer, size); \
+    }
+
+#define F1D_STRUCT_ASSEMBLE_FACTORY(Name, NF, Fields, Layout) \
+template <typename Policy> \
+class F1D_STRUCT_BASIC_FACTORY_NAME(Name) { \
 private: \
     Name _obj; \
     bool _begun; \
     bool _ended; \
-    std::vector<bool> _set_fields; \
+    f1d::field_mask<NF> _set_fields; \
     inline static const char* get_struct_name() \
     { \
         return Name::get_struct_name(); \
     } \
     inline bool all_set() const \
     { \
-        for (size_t i = 0; i < _set_fields.size(); i++) \
-            if (!_set_fields[i]) return false; \
-        return true; \
+        return _set_fields.all(); \
+    } \
+    inline f1d::error_code try_mark(unsigned int index) \
+    { \
+        if (Policy::checked) { \
+            if (!_begun) \
+                return f1d::not_initialized_error; \
+            if (_ended) \
+                return f1d::already_finished_error; \
+            if (_set_fields.test(index)) \
+                return f1d::already_set_error; \
+            _set_fields.set(index); \
+        } \
+        count_access(index); \
+        return f1d::no_error; \
+    } \
+    inline static void count_access(unsigned int index) \
+    { \
+        F1D_STRUCT_COUNT_ACCESS(Name, index) \
+    } \
+    inline static void raise(f1d::error_code error, unsigned int index, \
+        const char* name) \
+    { \
+        switch (error) { \
+        case f1d::not_initialized_error: \
+            F1D_THROW(f1d::not_intialized_exception() \
+                << f1d::struct_name(get_struct_name())); \
+        case f1d::not_finished_error: \
+            F1D_THROW(f1d::not_finished_exception() \
+                << f1d::struct_name(get_struct_name())); \
+        case f1d::already_finished_error: \
+            F1D_THROW(f1d::already_finished_exception() \
+                << f1d::struct_name(get_struct_name())); \
+        case f1d::already_set_error: \
+            F1D_THROW(f1d::already_set_exception() \
+                << f1d::struct_name(get_struct_name()) \
+                << f1d::field_index(index) \
+                << f1d::field_name(name)); \
+        default: \
+            break; \
+        } \
     } \
     inline void assert_fields() const \
     { \
-        bool failed = false; \
+        if (all_set()) { \
+            return; \
+        } \
         std::vector<unsigned int> indices; \
         std::vector<std::string> names; \
-        for (unsigned int i = 0; i < _set_fields.size(); i++) { \
-            if (!_set_fields[i]) { \
-                failed = true; \
+        for (unsigned int i = 0; i < NF; i++) { \
+            if (!_set_fields.test(i)) { \
                 indices.push_back(i); \
                 names.push_back(Name::get_field_name(i)); \
             } \
         } \
-        if (failed) { \
-            EX3_THROW(f1d::not_set_exception() \
-                << f1d::struct_name(get_struct_name()) \
-                << f1d::field_indices(indices) \
-                << f1d::field_names(names)); \
-        } \
+        F1D_THROW(f1d::not_set_exception() \
+            << f1d::struct_name(get_struct_name()) \
+            << f1d::field_indices(indices) \
+            << f1d::field_names(names)); \
     } \
 public: \
-    inline F1D_STRUCT_FACTORY_NAME(Name)() : \
+    typedef Policy policy_type; \
+    inline F1D_STRUCT_BASIC_FACTORY_NAME(Name)() : \
         _obj(), \
         _begun(false), \
         _ended(false), \
-        _set_fields(NF) \
+        _set_fields() \
     { \
     } \
+    inline f1d::error_code try_begin() \
+    { \
+        if (Policy::checked) { \
+            if (_begun && !_ended) \
+                return f1d::not_finished_error; \
+            _begun = true; \
+            _ended = false; \
+            _set_fields.reset(); \
+        } \
+        return f1d::no_error; \
+    } \
     inline void begin() \
     { \
-        if (_begun && !_ended) {\
-            EX3_THROW(f1d::not_finished_exception() \
-                << f1d::struct_name(get_struct_name())); \
+        const f1d::error_code error = try_begin(); \
+        if (error != f1d::no_error) { \
+            raise(error, 0, ""); \
+        } \
+    } \
+    inline f1d::error_code try_end() \
+    { \
+        if (Policy::checked) { \
+            if (!_begun) \
+                return f1d::not_initialized_error; \
+            if (_ended) \
+                return f1d::already_finished_error; \
+            if (!all_set()) \
+                return f1d::not_set_error; \
+            _ended = true; \
         } \
-        _begun = true; \
-        _ended = false; \
-        std::fill(_set_fields.begin(), _set_fields.end(), false); \
+        return f1d::no_error; \
     } \
     inline void end() \
     { \
-        if (!_begun) { \
-            EX3_THROW(f1d::not_intialized_exception() \
-                << f1d::struct_name(get_struct_name())); \
+        const f1d::error_code error = try_end(); \
+        if (error == f1d::not_set_error) { \
+            assert_fields(); \
         } \
-        if (_ended) { \
-            EX3_THROW(f1d::already_finished_exception() \
-                << f1d::struct_name(get_struct_name())); \
+        else if (error != f1d::no_error) { \
+            raise(error, 0, ""); \
         } \
-        assert_fields(); \
-        _ended = true; \
     } \
     inline const Name& get() const \
     { \
-        if (!_begun) { \
-            EX3_THROW(f1d::not_intialized_exception() \
-                << f1d::struct_name(get_struct_name())); \
+        if (Policy::checked) { \
+            if (!_begun) { \
+                F1D_THROW(f1d::not_intialized_exception() \
+                    << f1d::struct_name(get_struct_name())); \
+            } \
+            if (!_ended) { \
+                F1D_THROW(f1d::not_finished_exception() \
+                    << f1d::struct_name(get_struct_name())); \
+            } \
+        } \
+        return _obj; \
+    } \
+    inline Name take() \
+    { \
+        if (Policy::checked) { \
+            if (!_begun) { \
+                F1D_THROW(f1d::not_intialized_exception() \
+                    << f1d::struct_name(get_struct_name())); \
+            } \
+            if (!_ended) { \
+                F1D_THROW(f1d::not_finished_exception() \
+                    << f1d::struct_name(get_struct_name())); \
+            } \
+            _begun = false; \
         } \
-        if (!_ended) { \
-            EX3_THROW(f1d::not_finished_exception() \
+        return std::move(_obj); \
+    } \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_INITS, \
+        (types, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
+}; \
+typedef F1D_STRUCT_BASIC_FACTORY_NAME(Name)<F1D_DEFAULT_FACTORY_POLICY> \
+    F1D_STRUCT_FACTORY_NAME(Name); \
+F1D_STRUCT_ASSEMBLE_BATCH_FACTORY(Name, NF, Fields)
+
+/**
+ * Factory that builds a batch of structs from one column per field. The
+ * setters only store the columns, which must remain valid until append,
+ * so the validation runs once per batch instead of once per struct.
+ * append only accepts vectors and SoA containers of the same struct.
+ */
+#define F1D_STRUCT_ASSEMBLE_BATCH_FACTORY(Name, NF, Fields) \
+template <typename Policy> \
+class F1D_STRUCT_BASIC_BATCH_FACTORY_NAME(Name) { \
+private: \
+    const void* _columns[NF]; \
+    size_t _size; \
+    bool _begun; \
+    bool _ended; \
+    f1d::field_mask<NF> _set_fields; \
+    inline static const char* get_struct_name() \
+    { \
+        return Name::get_struct_name(); \
+    } \
+    inline void raise(f1d::error_code error, unsigned int index, \
+        const char* name) const \
+    { \
+        switch (error) { \
+        case f1d::not_initialized_error: \
+            F1D_THROW(f1d::not_intialized_exception() \
+                << f1d::struct_name(get_struct_name())); \
+        case f1d::not_finished_error: \
+            F1D_THROW(f1d::not_finished_exception() \
                 << f1d::struct_name(get_struct_name())); \
+        case f1d::already_finished_error: \
+            F1D_THROW(f1d::already_finished_exception() \
+                << f1d::struct_name(get_struct_name())); \
+        case f1d::already_set_error: \
+            F1D_THROW(f1d::already_set_exception() \
+                << f1d::struct_name(get_struct_name()) \
+                << f1d::field_index(index) \
+                << f1d::field_name(name)); \
+        case f1d::size_mismatch_error: \
+            F1D_THROW(f1d::size_mismatch_exception() \
+                << f1d::struct_name(get_struct_name()) \
+                << f1d::field_index(index) \
+                << f1d::field_name(name) \
+                << f1d::batch_size(_size)); \
+        case f1d::not_set_error: \
+            f1d::detail::throw_not_set<Name>(_set_fields); \
+        default: \
+            break; \
         } \
-        return _obj; \
     } \
-    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_INITS, types, Fields) \
+public: \
+    typedef Policy policy_type; \
+    inline F1D_STRUCT_BASIC_BATCH_FACTORY_NAME(Name)() : \
+        _columns(), \
+        _size(0), \
+        _begun(false), \
+        _ended(false), \
+        _set_fields() \
+    { \
+    } \
+    inline size_t size() const \
+    { \
+        return _size; \
+    } \
+    inline f1d::error_code try_begin(size_t size) \
+    { \
+        if (Policy::checked) { \
+            if (_begun && !_ended) \
+                return f1d::not_finished_error; \
+            _begun = true; \
+            _ended = false; \
+            _set_fields.reset(); \
+        } \
+        _size = size; \
+        return f1d::no_error; \
+    } \
+    inline void begin(size_t size) \
+    { \
+        const f1d::error_code error = try_begin(size); \
+        if (error != f1d::no_error) { \
+            raise(error, 0, ""); \
+        } \
+    } \
+    inline f1d::error_code try_end() \
+    { \
+        if (Policy::checked) { \
+            if (!_begun) \
+                return f1d::not_initialized_error; \
+            if (_ended) \
+                return f1d::already_finished_error; \
+            if (!_set_fields.all()) \
+                return f1d::not_set_error; \
+            _ended = true; \
+        } \
+        return f1d::no_error; \
+    } \
+    inline void end() \
+    { \
+        const f1d::error_code error = try_end(); \
+        if (error != f1d::no_error) { \
+            raise(error, 0, ""); \
+        } \
+    } \
+    template <typename Container> \
+    typename std::enable_if< \
+        std::is_same<typename Container::value_type, Name>::value>::type \
+    append(Container& out) const \
+    { \
+        if (Policy::checked) { \
+            if (!_begun) \
+                raise(f1d::not_initialized_error, 0, ""); \
+            if (!_ended) \
+                raise(f1d::not_finished_error, 0, ""); \
+        } \
+        f1d::detail::batch_append(out, _columns, _size); \
+    } \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_BATCH_INITS, types, Fields) \
 }; \
+typedef F1D_STRUCT_BASIC_BATCH_FACTORY_NAME(Name)< \
+    F1D_DEFAULT_FACTORY_POLICY> F1D_STRUCT_BATCH_FACTORY_NAME(Name);
+
+/**
+ * Preprocessor backend, every property of the fields is expanded from the
+ * field sequence.
+ */
+#define F1D_STRUCT_MAKE_S1(Name, NF, Fields, Traits, Layout) \
 namespace types { \
-    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_SUPER_FIELDS, Name, Fields) \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_TYPES, 0, Fields) \
+} \
+struct Name { \
+    static const unsigned int num_fields = NF; \
+    typedef f1d::type_list< \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_TLIST, types, Fields) \
+    > field_types; \
+    BOOST_PP_CAT(Layout, _MEMBERS)(Name, Fields) \
+    template <typename Dummy> \
+    struct basic_metadata \
+    { \
+        static constexpr const char* field_names[] = { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_NAMES, 0, Fields) \
+            "" \
+        }; \
+        static constexpr const char* type_names[] = { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_TNAMES, 0, Fields) \
+            "" \
+        }; \
+        static constexpr size_t type_sizes[] = { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_TSIZES, 0, Fields) \
+            0 \
+        }; \
+        static constexpr size_t field_alignments[] = { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_TALIGNS, 0, Fields) \
+            0 \
+        }; \
+        static constexpr size_t field_offsets[] = { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_FOFFSETS, \
+                (Name, BOOST_PP_CAT(Layout, _OFFSET)), Fields) \
+            0 \
+        }; \
+    }; \
+    typedef basic_metadata<void> metadata; \
+    inline static f1d::error_code try_get_field_index(const char* name, \
+        size_t length, unsigned int& index) \
+    { \
+        switch (f1d::name_hash(name, length)) { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_SNAMES, 0, Fields) \
+        default: \
+            break; \
+        } \
+        return f1d::not_found_error; \
+    } \
+    static const size_t packed_size = 0 \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_PSIZES, 0, Fields); \
+    template <typename Functor> \
+    void apply(Functor& f) \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+            (Name, *this, f, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
+    } \
+    template <typename Functor> \
+    void capply(Functor& f) const \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+            (Name, *this, f, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
+    } \
+    template <typename Functor> \
+    void apply(const Functor& f) \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+            (Name, *this, f, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
+    } \
+    template <typename Functor> \
+    void capply(const Functor& f) const \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+            (Name, *this, f, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
+    } \
+    template <typename Obj, typename Functor> \
+    static f1d::error_code dispatch_field(Obj& obj, unsigned int index, \
+        Functor& f) \
+    { \
+        switch (index) { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_VISITS, \
+            (Name, obj, f, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
+        default: \
+            break; \
+        } \
+        return f1d::not_found_error; \
+    } \
+    F1D_STRUCT_ASSEMBLE_METHODS(Name, NF) \
+}; \
+template <typename Dummy> \
+constexpr const char* Name::basic_metadata<Dummy>::field_names[]; \
+template <typename Dummy> \
+constexpr const char* Name::basic_metadata<Dummy>::type_names[]; \
+template <typename Dummy> \
+constexpr size_t Name::basic_metadata<Dummy>::type_sizes[]; \
+template <typename Dummy> \
+constexpr size_t Name::basic_metadata<Dummy>::field_alignments[]; \
+template <typename Dummy> \
+constexpr size_t Name::basic_metadata<Dummy>::field_offsets[]; \
+F1D_STRUCT_ASSEMBLE_FACTORY(Name, NF, Fields, Layout) \
+namespace types { \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_SUPER_FIELDS, \
+        (Name, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
 } \
 Traits() \
 namespace traits { \
@@ -478,13 +1277,120 @@ namespace traits { \
         Fields) \
 }
 
+/**
+ * Variadic backend, the field sequence is expanded once into a list of
+ * field descriptors and the metadata, name lookup, apply methods and
+ * traits are derived from it by f1d::field_table.
+ */
+#define F1D_STRUCT_MAKE_V1(Name, NF, Fields, Traits, Layout) \
+namespace types { \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_METAS, \
+        (BOOST_PP_CAT(Layout, _FIELD), BOOST_PP_CAT(Layout, _OFFSET)), \
+        Fields) \
+} \
+struct Name { \
+    static const unsigned int num_fields = NF; \
+    typedef f1d::field_table<f1d::type_list< \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_MLIST, types, Fields) \
+    > > field_table; \
+    typedef field_table::value_types field_types; \
+    BOOST_PP_CAT(Layout, _MEMBERS)(Name, Fields) \
+    typedef field_table::metadata<Name> metadata; \
+    inline static f1d::error_code try_get_field_index(const char* name, \
+        size_t length, unsigned int& index) \
+    { \
+        return field_table::find(name, length, index); \
+    } \
+    static const size_t packed_size = field_table::packed_size; \
+    template <typename Functor> \
+    void apply(Functor& f) \
+    { \
+        field_table::apply<Name>(*this, f); \
+    } \
+    template <typename Functor> \
+    void capply(Functor& f) const \
+    { \
+        field_table::apply<Name>(*this, f); \
+    } \
+    template <typename Functor> \
+    void apply(const Functor& f) \
+    { \
+        field_table::apply<Name>(*this, f); \
+    } \
+    template <typename Functor> \
+    void capply(const Functor& f) const \
+    { \
+        field_table::apply<Name>(*this, f); \
+    } \
+    template <typename Obj, typename Functor> \
+    static f1d::error_code dispatch_field(Obj& obj, unsigned int index, \
+        Functor& f) \
+    { \
+        return field_table::visit<Name>(obj, index, f); \
+    } \
+    F1D_STRUCT_ASSEMBLE_METHODS(Name, NF) \
+}; \
+F1D_STRUCT_ASSEMBLE_FACTORY(Name, NF, Fields, Layout) \
+namespace types { \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_SUPER_FIELDS, \
+        (Name, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
+} \
+Traits() \
+namespace traits { \
+    template <unsigned int I> \
+    struct value_type<Name, I> \
+    { \
+        typedef typename Name::field_table::template value_type<I>::type \
+            type; \
+    }; \
+    template <unsigned int I> \
+    struct field_wrapper_type<Name, I> \
+    { \
+        typedef typename Name::field_table::template wrapper_type<I>::type \
+            type; \
+    }; \
+}
+
+/**
+ * Backend used by the F1D_STRUCT_MAKE macros. The variadic backend is
+ * selected by defining F1D_VARIADIC_BACKEND, it is faster to compile for
+ * large structs.
+ */
+#ifdef F1D_VARIADIC_BACKEND
+#define F1D_STRUCT_MAKE_BACKEND F1D_STRUCT_MAKE_V1
+#else
+#define F1D_STRUCT_MAKE_BACKEND F1D_STRUCT_MAKE_S1
+#endif
+
 #define F1D_STRUCT_MAKE(Name, Fields) \
-    F1D_STRUCT_MAKE_S1(Name, BOOST_PP_SEQ_SIZE(Fields), Fields, \
-        F1D_BASE_TRAITS)
+    F1D_IGNORE_OFFSETOF_WARNING_BEGIN() \
+    F1D_STRUCT_MAKE_BACKEND(Name, BOOST_PP_SEQ_SIZE(Fields), Fields, \
+        F1D_BASE_TRAITS, F1D_LAYOUT_PLAIN) \
+    F1D_IGNORE_OFFSETOF_WARNING_END()
 
 #define F1D_STRUCT_MAKE_NT(Name, Fields) \
-    F1D_STRUCT_MAKE_S1(Name, BOOST_PP_SEQ_SIZE(Fields), Fields, \
-        F1D_NO_TRAITS)
+    F1D_IGNORE_OFFSETOF_WARNING_BEGIN() \
+    F1D_STRUCT_MAKE_BACKEND(Name, BOOST_PP_SEQ_SIZE(Fields), Fields, \
+        F1D_NO_TRAITS, F1D_LAYOUT_PLAIN) \
+    F1D_IGNORE_OFFSETOF_WARNING_END()
+
+/**
+ * Same as F1D_STRUCT_MAKE, but the fields are stored sorted by decreasing
+ * alignment to minimize padding and are accessed as methods, obj.name().
+ * Field indices, names, traits and the apply order follow the declaration
+ * order.
+ */
+#define F1D_STRUCT_MAKE_PACKED(Name, Fields) \
+    F1D_IGNORE_OFFSETOF_WARNING_BEGIN() \
+    F1D_STRUCT_MAKE_BACKEND(Name, BOOST_PP_SEQ_SIZE(Fields), Fields, \
+        F1D_BASE_TRAITS, F1D_LAYOUT_PACKED) \
+    F1D_IGNORE_OFFSETOF_WARNING_END()
+
+#define F1D_STRUCT_MAKE_PACKED_NT(Name, Fields) \
+    F1D_IGNORE_OFFSETOF_WARNING_BEGIN() \
+    F1D_STRUCT_MAKE_BACKEND(Name, BOOST_PP_SEQ_SIZE(Fields), Fields, \
+        F1D_NO_TRAITS, F1D_LAYOUT_PACKED) \
+    F1D_IGNORE_OFFSETOF_WARNING_END()
 
 #define F1D_TRAITS_MAKE() \
     F1D_BASE_TRAITS()
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "field_reader.hpp"
+#include "selection.hpp"
+
+#include <boost/cstdint.hpp>
+#include <boost/iterator/permutation_iterator.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace f1d {
+
+namespace detail {
+
+struct op_eq
+{
+    template <typename A, typename B>
+    bool operator ()(const A& a, const B& b) const
+    {
+        return a == b;
+    }
+};
+
+struct op_ne
+{
+    template <typename A, typename B>
+    bool operator ()(const A& a, const B& b) const
+    {
+        return !(a == b);
+    }
+};
+
+struct op_lt
+{
+    template <typename A, typename B>
+    bool operator ()(const A& a, const B& b) const
+    {
+        return a < b;
+    }
+};
+
+struct op_le
+{
+    template <typename A, typename B>
+    bool operator ()(const A& a, const B& b) const
+    {
+        return !(b < a);
+    }
+};
+
+struct op_gt
+{
+    template <typename A, typename B>
+    bool operator ()(const A& a, const B& b) const
+    {
+        return b < a;
+    }
+};
+
+struct op_ge
+{
+    template <typename A, typename B>
+    bool operator ()(const A& a, const B& b) const
+    {
+        return !(a < b);
+    }
+};
+
+}
+
+/**
+ * Compares the field against a constant, e.g. lt(10) selects the rows
+ * where the field is less than 10.
+ */
+template <typename T, typename Op>
+struct compare_predicate
+{
+    T value;
+
+    explicit compare_predicate(const T& value) :
+        value(value)
+    {
+    }
+
+    template <typename V>
+    bool operator ()(const V& v) const
+    {
+        return Op()(v, value);
+    }
+};
+
+/**
+ * Selects the fields in the closed range [low, high].
+ */
+template <typename T>
+struct range_predicate
+{
+    T low;
+    T high;
+
+    range_predicate(const T& low, const T& high) :
+        low(low),
+        high(high)
+    {
+    }
+
+    template <typename V>
+    bool operator ()(const V& v) const
+    {
+        return !(v < low) && !(high < v);
+    }
+};
+
+/**
+ * Selects the fields equal to one of a list of values. Short lists are
+ * scanned, longer ones are sorted and searched.
+ */
+template <typename T>
+class in_predicate
+{
+private:
+
+    static const size_t scan_limit = 8;
+
+    std::vector<T> _values;
+
+public:
+
+    explicit in_predicate(const std::vector<T>& values) :
+        _values(values)
+    {
+        std::sort(_values.begin(), _values.end());
+    }
+
+    const std::vector<T>& values() const
+    {
+        return _values;
+    }
+
+    template <typename V>
+    bool operator ()(const V& v) const
+    {
+        if (_values.size() <= scan_limit) {
+            bool found = false;
+            for (size_t i = 0; i < _values.size(); i++)
+                found |= v == _values[i];
+            return found;
+        }
+
+        return std::binary_search(_values.begin(), _values.end(), v);
+    }
+};
+
+template <typename T>
+compare_predicate<T, detail::op_eq> eq(const T& value)
+{
+    return compare_predicate<T, detail::op_eq>(value);
+}
+
+template <typename T>
+compare_predicate<T, detail::op_ne> ne(const T& value)
+{
+    return compare_predicate<T, detail::op_ne>(value);
+}
+
+template <typename T>
+compare_predicate<T, detail::op_lt> lt(const T& value)
+{
+    return compare_predicate<T, detail::op_lt>(value);
+}
+
+template <typename T>
+compare_predicate<T, detail::op_le> le(const T& value)
+{
+    return compare_predicate<T, detail::op_le>(value);
+}
+
+template <typename T>
+compare_predicate<T, detail::op_gt> gt(const T& value)
+{
+    return compare_predicate<T, detail::op_gt>(value);
+}
+
+template <typename T>
+compare_predicate<T, detail::op_ge> ge(const T& value)
+{
+    return compare_predicate<T, detail::op_ge>(value);
+}
+
+template <typename T>
+range_predicate<T> between(const T& low, const T& high)
+{
+    return range_predicate<T>(low, high);
+}
+
+template <typename T>
+in_predicate<T> in(const std::vector<T>& values)
+{
+    return in_predicate<T>(values);
+}
+
+template <typename T>
+in_predicate<T> in(std::initializer_list<T> values)
+{
+    return in_predicate<T>(std::vector<T>(values));
+}
+
+/**
+ * Select the rows of a vector of structs or of an SoA container whose
+ * field, given as a field wrapper, satisfies the predicate. Any function
+ * object taking the field value works as a predicate.
+ */
+template <typename Field, typename Container, typename Predicate>
+void select(const Container& c, Predicate pred, selection& out)
+{
+    const detail::field_reader<Field, Container> read(c);
+    const size_t n = c.size();
+
+    out.resize(n);
+
+    // Branchless: every row is written, only the selected ones are kept
+    size_t k = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        out[k] = i;
+        k += pred(read(i)) ? 1 : 0;
+    }
+
+    out.resize(k);
+}
+
+template <typename Field, typename Container, typename Predicate>
+void select(const Container& c, Predicate pred, selection_bitmap& out)
+{
+    const detail::field_reader<Field, Container> read(c);
+    const size_t n = c.size();
+
+    out.reset(n);
+
+    boost::uint64_t* words = out.words();
+
+    for (size_t w = 0; w < out.num_words(); w++) {
+
+        const size_t begin = w * selection_bitmap::word_bits;
+        const size_t end = std::min(n, begin + selection_bitmap::word_bits);
+
+        boost::uint64_t word = 0;
+
+        for (size_t i = begin; i < end; i++)
+            word |= boost::uint64_t(pred(read(i)) ? 1 : 0) << (i - begin);
+
+        words[w] = word;
+    }
+}
+
+/**
+ * Keep only the selected rows whose field satisfies the predicate, to
+ * combine conditions on several fields.
+ */
+template <typename Field, typename Container, typename Predicate>
+void refine(const Container& c, Predicate pred, selection& rows)
+{
+    const detail::field_reader<Field, Container> read(c);
+
+    size_t k = 0;
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        const size_t row = rows[i];
+        rows[k] = row;
+        k += pred(read(row)) ? 1 : 0;
+    }
+
+    rows.resize(k);
+}
+
+template <typename Field, typename Container, typename Predicate>
+void refine(const Container& c, Predicate pred, selection_bitmap& rows)
+{
+    selection_bitmap other;
+    select<Field>(c, pred, other);
+    rows &= other;
+}
+
+/**
+ * Copy the field of the selected rows.
+ */
+template <typename Field, typename Container>
+void project(const Container& c, const selection& rows,
+    std::vector<typename Field::value_type>& out)
+{
+    const detail::field_reader<Field, Container> read(c);
+
+    out.resize(rows.size());
+
+    for (size_t i = 0; i < rows.size(); i++)
+        out[i] = read(rows[i]);
+}
+
+/**
+ * Range over the selected elements of a container with iterators, such
+ * as a vector of structs, that can be passed to write_record_file or
+ * any other algorithm without copying the elements.
+ */
+template <typename Container>
+boost::iterator_range<boost::permutation_iterator<
+    typename Container::const_iterator, selection::const_iterator> >
+selected(const Container& c, const selection& rows)
+{
+    return boost::make_iterator_range(
+        boost::make_permutation_iterator(c.begin(), rows.begin()),
+        boost::make_permutation_iterator(c.begin(), rows.end()));
+}
+
+}
@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "type_list.hpp"
+
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+/**
+ * Specialize std::hash for an f1d struct. Must be used in the global
+ * namespace with the fully qualified name of the struct.
+ */
+#define F1D_STRUCT_STD_HASH(QualifiedName) \
+namespace std { \
+    template <> \
+    struct hash<QualifiedName> \
+    { \
+        size_t operator ()(const QualifiedName& obj) const \
+        { \
+            return f1d::hash_struct(obj); \
+        } \
+    }; \
+}
+
+namespace f1d {
+
+/**
+ * MurmurHash64A of a byte range.
+ */
+inline size_t hash_bytes(
+    const void* data,
+    size_t length,
+    boost::uint64_t seed = 0)
+{
+    const boost::uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+
+    const unsigned char* in = static_cast<const unsigned char*>(data);
+    const unsigned char* end = in + (length / 8) * 8;
+
+    boost::uint64_t h = seed ^ (length * m);
+
+    for (; in != end; in += 8) {
+
+        boost::uint64_t k;
+        std::memcpy(&k, in, sizeof(k));
+
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+
+        h ^= k;
+        h *= m;
+    }
+
+    switch (length & 7) {
+    case 7: h ^= boost::uint64_t(in[6]) << 48; // fall through
+    case 6: h ^= boost::uint64_t(in[5]) << 40; // fall through
+    case 5: h ^= boost::uint64_t(in[4]) << 32; // fall through
+    case 4: h ^= boost::uint64_t(in[3]) << 24; // fall through
+    case 3: h ^= boost::uint64_t(in[2]) << 16; // fall through
+    case 2: h ^= boost::uint64_t(in[1]) << 8;  // fall through
+    case 1: h ^= boost::uint64_t(in[0]);
+        h *= m;
+    default:
+        break;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+
+    return static_cast<size_t>(h);
+}
+
+inline size_t hash_combine(size_t seed, size_t value)
+{
+    return seed ^ (value + static_cast<size_t>(0x9e3779b97f4a7c15ULL) +
+        (seed << 6) + (seed >> 2));
+}
+
+/**
+ * True when equal values of T always have equal bytes, so they can be
+ * hashed and compared as raw memory. Floating point types are excluded
+ * because of signed zeros. Specialize for other types with unique
+ * representations, class types are never detected since they may define
+ * their own operator ==.
+ */
+template <typename T>
+struct is_bitwise_hashable
+{
+    static const bool value = std::is_integral<T>::value ||
+        std::is_enum<T>::value || std::is_pointer<T>::value;
+};
+
+template <typename T>
+const bool is_bitwise_hashable<T>::value;
+
+namespace detail {
+
+template <typename List>
+struct bitwise_flags;
+
+template <typename... Ts>
+struct bitwise_flags<type_list<Ts...> >
+{
+    static constexpr bool values[] = {
+        is_bitwise_hashable<Ts>::value..., false };
+};
+
+template <typename... Ts>
+constexpr bool bitwise_flags<type_list<Ts...> >::values[];
+
+template <typename S, unsigned int I>
+const typename type_at<I, typename S::field_types>::type& field_at(
+    const S& obj)
+{
+    typedef typename type_at<I, typename S::field_types>::type T;
+    return *reinterpret_cast<const T*>(
+        reinterpret_cast<const char*>(&obj) + S::get_field_offset(I));
+}
+
+template <typename S, unsigned int I>
+typename type_at<I, typename S::field_types>::type& field_at(S& obj)
+{
+    typedef typename type_at<I, typename S::field_types>::type T;
+    return *reinterpret_cast<T*>(
+        reinterpret_cast<char*>(&obj) + S::get_field_offset(I));
+}
+
+template <typename S>
+constexpr bool is_bitwise_field(unsigned int i)
+{
+    return bitwise_flags<typename S::field_types>::values[i];
+}
+
+/**
+ * One past the last field of the run of bitwise hashable fields starting
+ * at i that are laid out next to each other without padding.
+ */
+template <typename S>
+constexpr unsigned int bitwise_run_end(unsigned int i)
+{
+    return i + 1 < S::num_fields && is_bitwise_field<S>(i + 1) &&
+        S::get_field_offset(i) + S::get_type_size(i) ==
+        S::get_field_offset(i + 1) ? bitwise_run_end<S>(i + 1) : i + 1;
+}
+
+template <typename S, unsigned int I,
+    bool End = (I == S::num_fields),
+    bool Bitwise = is_bitwise_field<S>(I)>
+struct struct_hasher
+{
+    static const unsigned int next = bitwise_run_end<S>(I);
+
+    static size_t hash(const S& obj, size_t seed)
+    {
+        const size_t begin = S::get_field_offset(I);
+        const size_t end = S::get_field_offset(next - 1) +
+            S::get_type_size(next - 1);
+
+        seed = hash_bytes(reinterpret_cast<const char*>(&obj) + begin,
+            end - begin, seed);
+
+        return struct_hasher<S, next>::hash(obj, seed);
+    }
+};
+
+template <typename S, unsigned int I>
+struct struct_hasher<S, I, false, false>
+{
+    static size_t hash(const S& obj, size_t seed)
+    {
+        typedef typename type_at<I, typename S::field_types>::type T;
+
+        seed = hash_combine(seed, boost::hash<T>()(field_at<S, I>(obj)));
+
+        return struct_hasher<S, I + 1>::hash(obj, seed);
+    }
+};
+
+template <typename S, unsigned int I, bool Bitwise>
+struct struct_hasher<S, I, true, Bitwise>
+{
+    static size_t hash(const S&, size_t seed)
+    {
+        return seed;
+    }
+};
+
+template <typename S, unsigned int I, bool Bitwise = is_bitwise_field<S>(I)>
+struct single_field_hasher
+{
+    static size_t hash(const S& obj, size_t seed)
+    {
+        return hash_bytes(&field_at<S, I>(obj), S::get_type_size(I), seed);
+    }
+};
+
+template <typename S, unsigned int I>
+struct single_field_hasher<S, I, false>
+{
+    static size_t hash(const S& obj, size_t seed)
+    {
+        typedef typename type_at<I, typename S::field_types>::type T;
+        return hash_combine(seed, boost::hash<T>()(field_at<S, I>(obj)));
+    }
+};
+
+}
+
+/**
+ * Hash of all fields of an f1d struct. Runs of adjacent bitwise hashable
+ * fields are hashed in a single pass over their bytes, the other fields
+ * are hashed with boost::hash and combined, so padding never contributes
+ * to the hash.
+ */
+template <typename S>
+size_t hash_struct(const S& obj)
+{
+    return detail::struct_hasher<S, 0>::hash(obj, 0);
+}
+
+/**
+ * Hash function object for f1d structs, usable with unordered containers.
+ */
+template <typename S>
+struct struct_hash
+{
+    typedef S argument_type;
+    typedef size_t result_type;
+
+    size_t operator ()(const S& obj) const
+    {
+        return hash_struct(obj);
+    }
+};
+
+/**
+ * Hash function object of a subset of the fields, given as field
+ * wrappers, e.g. hash_fields<types::field1_f, types::field3_f>.
+ */
+template <typename... Fields>
+struct hash_fields
+{
+    template <typename S>
+    size_t operator ()(const S& obj) const
+    {
+        size_t seed = 0;
+        const int expand[] = { 0, (seed = detail::single_field_hasher<
+            S, Fields::index>::hash(obj, seed), 0)... };
+        (void)expand;
+        return seed;
+    }
+};
+
+}
@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "field_reader.hpp"
+
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace f1d {
+
+/**
+ * Unique hash index of the records of a container by one of their
+ * fields, given as a field wrapper, e.g. index<my_struct, types::id_f>.
+ * The container is a vector of structs or an SoA container and must
+ * outlive the index. Only row ids are stored, in a linear probing table
+ * with the hash of each key, so most probes do not touch the records.
+ * The index is not updated automatically: rows must be inserted after
+ * they are added to the container and erased before their key changes.
+ * The index keeps a pointer to the key column, refreshed by rebuild,
+ * insert and erase, so find must not be called between growing the
+ * container and inserting its new rows.
+ */
+template <typename S, typename Field,
+    typename Container = std::vector<S>,
+    typename Hash = boost::hash<typename Field::value_type>,
+    typename Equal = std::equal_to<typename Field::value_type> >
+class index
+{
+public:
+
+    typedef typename Field::value_type key_type;
+    typedef Container container_type;
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    static_assert(std::is_same<typename Container::value_type, S>::value,
+        "the container does not hold the indexed struct");
+
+private:
+
+    struct slot
+    {
+        size_t row;
+        size_t hash;
+    };
+
+    const Container* _records;
+    detail::field_reader<Field, Container> _read;
+    std::vector<slot> _slots;
+    size_t _size;
+    Hash _hasher;
+    Equal _equal;
+
+    size_t hash(const key_type& key) const
+    {
+        // Spread the bits of weak hashes, such as the identity hash of
+        // integers, over the whole table
+        boost::uint64_t h = _hasher(key);
+
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+
+        return static_cast<size_t>(h);
+    }
+
+    size_t mask() const
+    {
+        return _slots.size() - 1;
+    }
+
+    /**
+     * Position of the slot holding the key, or of the empty slot where
+     * it would be inserted.
+     */
+    size_t probe(const key_type& key, size_t h) const
+    {
+        for (size_t i = h & mask(); ; i = (i + 1) & mask()) {
+
+            const slot& s = _slots[i];
+
+            if (s.row == npos ||
+                (s.hash == h && _equal(_read(s.row), key)))
+                return i;
+        }
+    }
+
+    void place(size_t row, size_t h)
+    {
+        size_t i = h & mask();
+
+        while (_slots[i].row != npos)
+            i = (i + 1) & mask();
+
+        _slots[i].row = row;
+        _slots[i].hash = h;
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<slot> slots(capacity, slot{ npos, 0 });
+        _slots.swap(slots);
+
+        for (size_t i = 0; i < slots.size(); i++)
+            if (slots[i].row != npos)
+                place(slots[i].row, slots[i].hash);
+    }
+
+    /**
+     * Remove the slot and shift back the following slots of the cluster,
+     * so no tombstones are needed.
+     */
+    void remove(size_t i)
+    {
+        for (size_t j = (i + 1) & mask(); _slots[j].row != npos;
+            j = (j + 1) & mask()) {
+
+            const size_t k = _slots[j].hash & mask();
+
+            // Move the slot back unless its home lies in (i, j]
+            if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
+                continue;
+
+            _slots[i] = _slots[j];
+            i = j;
+        }
+
+        _slots[i].row = npos;
+        _size--;
+    }
+
+    /**
+     * Find the key column again, the container may have reallocated it.
+     */
+    void refresh()
+    {
+        _read = detail::field_reader<Field, Container>(*_records);
+    }
+
+    bool insert_row(size_t row)
+    {
+        reserve(_size + 1);
+
+        const key_type& key = _read(row);
+        const size_t h = hash(key);
+        slot& s = _slots[probe(key, h)];
+
+        if (s.row != npos)
+            return false;
+
+        s.row = row;
+        s.hash = h;
+        _size++;
+
+        return true;
+    }
+
+public:
+
+    /**
+     * Build the index over every row of the container.
+     */
+    explicit index(const Container& records,
+        const Hash& hasher = Hash(),
+        const Equal& equal = Equal()) :
+        _records(&records),
+        _read(records),
+        _slots(),
+        _size(0),
+        _hasher(hasher),
+        _equal(equal)
+    {
+        rebuild();
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     * Number of slots in the table.
+     */
+    size_t capacity() const
+    {
+        return _slots.size();
+    }
+
+    /**
+     * Grow the table to hold n rows without rehashing.
+     */
+    void reserve(size_t n)
+    {
+        size_t capacity = _slots.empty() ? 16 : _slots.size();
+
+        while (capacity * 3 < n * 4)
+            capacity *= 2;
+
+        if (capacity != _slots.size())
+            rehash(capacity);
+    }
+
+    void clear()
+    {
+        std::vector<slot>(_slots.size(), slot{ npos, 0 }).swap(_slots);
+        _size = 0;
+    }
+
+    /**
+     * Clear the index and insert every row of the container.
+     */
+    void rebuild()
+    {
+        clear();
+        reserve(_records->size());
+        refresh();
+
+        for (size_t row = 0; row < _records->size(); row++)
+            insert_row(row);
+    }
+
+    /**
+     * Index a row of the container. Returns false, without indexing it,
+     * when another row with the same key is already indexed.
+     */
+    bool insert(size_t row)
+    {
+        refresh();
+        return insert_row(row);
+    }
+
+    /**
+     * Remove a row from the index, looking it up by its current key.
+     * Returns false when the row is not indexed.
+     */
+    bool erase(size_t row)
+    {
+        if (_slots.empty())
+            return false;
+
+        refresh();
+
+        const key_type& key = _read(row);
+        const size_t i = probe(key, hash(key));
+
+        if (_slots[i].row != row)
+            return false;
+
+        remove(i);
+        return true;
+    }
+
+    /**
+     * Row with the key, or npos when no row has it.
+     */
+    size_t find(const key_type& key) const
+    {
+        if (_slots.empty())
+            return npos;
+
+        return _slots[probe(key, hash(key))].row;
+    }
+
+    bool contains(const key_type& key) const
+    {
+        return find(key) != npos;
+    }
+};
+
+template <typename S, typename Field, typename Container, typename Hash,
+    typename Equal>
+const size_t index<S, Field, Container, Hash, Equal>::npos;
+
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace f1d {
+
+namespace detail {
+
+template <typename S>
+struct thread_access_counts;
+
+/**
+ * Access counts of the fields of S: the counters of the running threads
+ * and the merged counts of the threads that already finished.
+ */
+template <typename S>
+struct access_registry
+{
+    std::mutex mutex;
+    std::vector<thread_access_counts<S>*> threads;
+    std::vector<boost::uint64_t> finished;
+
+    access_registry() :
+        mutex(),
+        threads(),
+        finished(S::num_fields, 0)
+    {
+    }
+
+    static access_registry& instance()
+    {
+        static access_registry registry;
+        return registry;
+    }
+};
+
+/**
+ * Access counters of a single thread. Only the owner thread writes them,
+ * so the increments need no read-modify-write, the atomics only make the
+ * reads of the other threads well defined.
+ */
+template <typename S>
+struct thread_access_counts
+{
+    std::atomic<boost::uint64_t> counts[S::num_fields];
+
+    thread_access_counts()
+    {
+        for (unsigned int i = 0; i < S::num_fields; i++)
+            counts[i].store(0, std::memory_order_relaxed);
+
+        access_registry<S>& registry = access_registry<S>::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(this);
+    }
+
+    ~thread_access_counts()
+    {
+        access_registry<S>& registry = access_registry<S>::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        for (unsigned int i = 0; i < S::num_fields; i++)
+            registry.finished[i] += counts[i].load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < registry.threads.size(); i++) {
+            if (registry.threads[i] == this) {
+                registry.threads[i] = registry.threads.back();
+                registry.threads.pop_back();
+                break;
+            }
+        }
+    }
+
+    static thread_access_counts& local()
+    {
+        static thread_local thread_access_counts counts;
+        return counts;
+    }
+};
+
+}
+
+/**
+ * Count an access to the field at the given index of S in the counters
+ * of the calling thread. Out of range indices are ignored.
+ */
+template <typename S>
+inline void count_field_access(unsigned int index)
+{
+    if (index >= S::num_fields)
+        return;
+
+    std::atomic<boost::uint64_t>& count =
+        detail::thread_access_counts<S>::local().counts[index];
+
+    count.store(count.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+}
+
+/**
+ * Access counts of each field of S, merged over all threads.
+ */
+template <typename S>
+std::vector<boost::uint64_t> get_field_access_counts()
+{
+    detail::access_registry<S>& registry =
+        detail::access_registry<S>::instance();
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<boost::uint64_t> counts(registry.finished);
+
+    for (size_t t = 0; t < registry.threads.size(); t++)
+        for (unsigned int i = 0; i < S::num_fields; i++)
+            counts[i] += registry.threads[t]->counts[i].load(
+                std::memory_order_relaxed);
+
+    return counts;
+}
+
+/**
+ * Reset the access counts of S. Accesses made by other threads while the
+ * counters are reset may be lost.
+ */
+template <typename S>
+void reset_field_access_counts()
+{
+    detail::access_registry<S>& registry =
+        detail::access_registry<S>::instance();
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::fill(registry.finished.begin(), registry.finished.end(), 0);
+
+    for (size_t t = 0; t < registry.threads.size(); t++)
+        for (unsigned int i = 0; i < S::num_fields; i++)
+            registry.threads[t]->counts[i].store(0,
+                std::memory_order_relaxed);
+}
+
+/**
+ * Number of accesses to a single field.
+ */
+struct field_access
+{
+    unsigned int index;
+    const char* name;
+    boost::uint64_t count;
+};
+
+/**
+ * Snapshot of the access counts of the fields of an f1d-generated struct
+ * built with F1D_INSTRUMENT, merged over all threads when the report is
+ * created.
+ */
+template <typename S>
+class field_access_report
+{
+private:
+
+    boost::uint64_t _total;
+    std::vector<field_access> _fields;
+
+public:
+
+    field_access_report() :
+        _total(0),
+        _fields(S::num_fields)
+    {
+        const std::vector<boost::uint64_t> counts =
+            get_field_access_counts<S>();
+
+        for (unsigned int i = 0; i < S::num_fields; i++) {
+
+            field_access& f = _fields[i];
+
+            f.index = i;
+            f.name = S::get_field_names()[i];
+            f.count = counts[i];
+
+            _total += f.count;
+        }
+    }
+
+    const std::vector<field_access>& fields() const
+    {
+        return _fields;
+    }
+
+    boost::uint64_t count(unsigned int index) const
+    {
+        return _fields[index].count;
+    }
+
+    boost::uint64_t total() const
+    {
+        return _total;
+    }
+
+    void print(std::ostream& out) const
+    {
+        out << S::get_struct_name()
+            << ": accesses " << _total
+            << "\n";
+
+        for (unsigned int i = 0; i < _fields.size(); i++) {
+
+            const field_access& f = _fields[i];
+
+            out << "  [" << f.index << "] "
+                << f.name << ": " << f.count
+                << "\n";
+        }
+    }
+};
+
+template <typename S>
+std::ostream& operator <<(std::ostream& out,
+    const field_access_report<S>& report)
+{
+    report.print(out);
+    return out;
+}
+
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <boost/preprocessor/stringize.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+/**
+ * Cache line size, in bytes, assumed by the layout reports.
+ */
+#ifndef F1D_CACHE_LINE_SIZE
+#define F1D_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * Fail to compile if the field Field of the struct StructName crosses a
+ * cache line boundary when the struct starts at the beginning of a line.
+ */
+#define F1D_ASSERT_FIELD_IN_CACHE_LINE(StructName, Field) \
+    static_assert(f1d::fits_cache_line( \
+        offsetof(StructName, Field), \
+        sizeof(StructName::Field), \
+        F1D_CACHE_LINE_SIZE), \
+        BOOST_PP_STRINGIZE(StructName) "::" BOOST_PP_STRINGIZE(Field) \
+        " straddles a cache line")
+
+namespace f1d {
+
+inline constexpr bool fits_cache_line(
+    size_t offset,
+    size_t size,
+    size_t line)
+{
+    return size == 0 || offset / line == (offset + size - 1) / line;
+}
+
+/**
+ * Placement of a single field inside its struct.
+ */
+struct field_layout
+{
+    unsigned int index;
+    const char* name;
+    const char* type_name;
+    size_t offset;
+    size_t size;
+    size_t alignment;
+    size_t padding;
+    size_t first_line;
+    size_t last_line;
+
+    bool straddles() const
+    {
+        return first_line != last_line;
+    }
+};
+
+/**
+ * Layout of an f1d-generated struct: the offset, size and alignment of
+ * each field, the padding inserted after it and the cache lines it
+ * occupies, assuming the struct starts at the beginning of a line.
+ */
+template <typename S>
+class layout_report
+{
+private:
+
+    size_t _line;
+    size_t _padding;
+    size_t _straddling;
+    std::vector<field_layout> _fields;
+
+public:
+
+    explicit layout_report(size_t line = F1D_CACHE_LINE_SIZE) :
+        _line(line),
+        _padding(0),
+        _straddling(0),
+        _fields(S::num_fields)
+    {
+        for (unsigned int i = 0; i < S::num_fields; i++) {
+
+            field_layout& f = _fields[i];
+
+            f.index = i;
+            f.name = S::get_field_names()[i];
+            f.type_name = S::get_type_names()[i];
+            f.offset = S::get_field_offsets()[i];
+            f.size = S::get_type_sizes()[i];
+            f.alignment = S::get_field_alignments()[i];
+            f.first_line = f.offset / line;
+            f.last_line = (f.offset + (f.size ? f.size - 1 : 0)) / line;
+
+            if (f.straddles())
+                _straddling++;
+        }
+
+        // Packed structs do not store the fields in declaration order,
+        // so the padding goes up to the next field in memory
+        size_t first = sizeof(S);
+
+        for (unsigned int i = 0; i < S::num_fields; i++) {
+
+            field_layout& f = _fields[i];
+            size_t next = sizeof(S);
+
+            for (unsigned int j = 0; j < S::num_fields; j++)
+                if (_fields[j].offset > f.offset && _fields[j].offset < next)
+                    next = _fields[j].offset;
+
+            f.padding = next - (f.offset + f.size);
+            _padding += f.padding;
+            first = std::min(first, f.offset);
+        }
+
+        _padding += _fields.empty() ? 0 : first;
+    }
+
+    const std::vector<field_layout>& fields() const
+    {
+        return _fields;
+    }
+
+    size_t cache_line() const
+    {
+        return _line;
+    }
+
+    size_t struct_size() const
+    {
+        return sizeof(S);
+    }
+
+    size_t struct_alignment() const
+    {
+        return alignof(S);
+    }
+
+    size_t packed_size() const
+    {
+        return S::packed_size;
+    }
+
+    /**
+     * Total number of padding bytes, including the tail padding.
+     */
+    size_t padding() const
+    {
+        return _padding;
+    }
+
+    size_t cache_lines() const
+    {
+        return (sizeof(S) + _line - 1) / _line;
+    }
+
+    size_t num_straddling() const
+    {
+        return _straddling;
+    }
+
+    void print(std::ostream& out) const
+    {
+        out << S::get_struct_name()
+            << ": size " << sizeof(S)
+            << ", align " << alignof(S)
+            << ", packed " << S::packed_size
+            << ", padding " << _padding
+            << ", lines " << cache_lines()
+            << ", straddling " << _straddling
+            << "\n";
+
+        for (unsigned int i = 0; i < _fields.size(); i++) {
+
+            const field_layout& f = _fields[i];
+
+            out << "  [" << f.index << "] "
+                << f.name << " (" << f.type_name << ")"
+                << ": offset " << f.offset
+                << ", size " << f.size
+                << ", align " << f.alignment
+                << ", padding " << f.padding
+                << ", line " << f.first_line;
+
+            if (f.straddles())
+                out << "-" << f.last_line << " STRADDLES";
+
+            out << "\n";
+        }
+    }
+};
+
+template <typename S>
+std::ostream& operator <<(std::ostream& out, const layout_report<S>& report)
+{
+    report.print(out);
+    return out;
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+namespace f1d {
+
+/**
+ * Hash type used to dispatch field names in get_field_index.
+ */
+typedef boost::uint32_t name_hash_t;
+
+static const name_hash_t name_hash_basis = 2166136261u;
+static const name_hash_t name_hash_prime = 16777619u;
+
+/**
+ * FNV-1a hash of a field name, usable as a case label. The generated
+ * switch fails to compile with a duplicate case value if two names of
+ * the same struct ever collide, so the dispatch is always perfect.
+ */
+inline constexpr name_hash_t static_name_hash(
+    const char* name,
+    size_t length,
+    name_hash_t hash = name_hash_basis)
+{
+    return length == 0 ? hash : static_name_hash(name + 1, length - 1,
+        (hash ^ static_cast<unsigned char>(*name)) * name_hash_prime);
+}
+
+/**
+ * Runtime version of static_name_hash, must produce the same values.
+ */
+inline name_hash_t name_hash(
+    const char* name,
+    size_t length)
+{
+    name_hash_t hash = name_hash_basis;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= name_hash_prime;
+    }
+
+    return hash;
+}
+
+/**
+ * Compare a runtime name against a field name after a hash match.
+ */
+inline bool name_equals(
+    const char* name,
+    size_t length,
+    const char* field_name,
+    size_t field_length)
+{
+    return length == field_length &&
+        std::memcmp(name, field_name, length) == 0;
+}
+
+}
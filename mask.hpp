@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <boost/cstdint.hpp>
+
+namespace f1d {
+
+/**
+ * Fixed-size set of field flags stored inline as 64-bit words. For
+ * structs with up to 64 fields, checking if all flags are set is a
+ * single compare.
+ */
+template <unsigned int N>
+class field_mask
+{
+public:
+
+    typedef boost::uint64_t word_type;
+
+    static const unsigned int word_bits = 64;
+    static const unsigned int num_words = (N + word_bits - 1) / word_bits;
+
+    static const word_type last_word = (N % word_bits) == 0 ?
+        ~word_type(0) : (word_type(1) << (N % word_bits)) - 1;
+
+private:
+
+    word_type _words[num_words];
+
+public:
+
+    field_mask()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        for (unsigned int w = 0; w < num_words; w++)
+            _words[w] = 0;
+    }
+
+    bool test(unsigned int i) const
+    {
+        return (_words[i / word_bits] & (word_type(1) << (i % word_bits)))
+            != 0;
+    }
+
+    void set(unsigned int i)
+    {
+        _words[i / word_bits] |= word_type(1) << (i % word_bits);
+    }
+
+    bool all() const
+    {
+        for (unsigned int w = 0; w + 1 < num_words; w++)
+            if (_words[w] != ~word_type(0)) return false;
+        return _words[num_words - 1] == last_word;
+    }
+};
+
+template <unsigned int N>
+const unsigned int field_mask<N>::word_bits;
+
+template <unsigned int N>
+const unsigned int field_mask<N>::num_words;
+
+template <unsigned int N>
+const typename field_mask<N>::word_type field_mask<N>::last_word;
+
+}
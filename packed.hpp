@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "type_list.hpp"
+
+#include <cstddef>
+
+namespace f1d {
+
+template <typename List>
+class packed_layout;
+
+/**
+ * Physical placement of a list of fields sorted by decreasing alignment,
+ * ties keeping their declaration order. Since every size is a multiple of
+ * its alignment, the sorted fields are laid out without padding between
+ * them. Logical indices refer to the declaration order, slots to the
+ * physical order.
+ */
+template <typename... Ts>
+class packed_layout<type_list<Ts...> >
+{
+public:
+
+    typedef type_list<Ts...> list_type;
+
+    static const unsigned int size = sizeof...(Ts);
+
+private:
+
+    static constexpr size_t _sizes[] = { sizeof(Ts)... };
+    static constexpr size_t _alignments[] = { alignof(Ts)... };
+
+    static constexpr bool goes_before(unsigned int j, unsigned int i)
+    {
+        return _alignments[j] > _alignments[i] ||
+            (_alignments[j] == _alignments[i] && j < i);
+    }
+
+    static constexpr unsigned int count_before(unsigned int i,
+        unsigned int j)
+    {
+        return j == size ? 0 :
+            (goes_before(j, i) ? 1 : 0) + count_before(i, j + 1);
+    }
+
+    static constexpr unsigned int find_field(unsigned int p, unsigned int i)
+    {
+        return slot(i) == p ? i : find_field(p, i + 1);
+    }
+
+    static constexpr size_t slot_offset(unsigned int p)
+    {
+        return p == 0 ? 0 : slot_offset(p - 1) + _sizes[field(p - 1)];
+    }
+
+public:
+
+    /**
+     * Physical slot of the field with logical index i.
+     */
+    static constexpr unsigned int slot(unsigned int i)
+    {
+        return count_before(i, 0);
+    }
+
+    /**
+     * Logical index of the field stored in slot p.
+     */
+    static constexpr unsigned int field(unsigned int p)
+    {
+        return find_field(p, 0);
+    }
+
+    /**
+     * Offset of the field with logical index i from the start of the
+     * storage.
+     */
+    static constexpr size_t offset(unsigned int i)
+    {
+        return slot_offset(slot(i));
+    }
+
+    template <unsigned int P>
+    struct slot_type
+    {
+        typedef typename type_at<field(P), list_type>::type type;
+    };
+};
+
+template <typename... Ts>
+const unsigned int packed_layout<type_list<Ts...> >::size;
+
+template <typename... Ts>
+constexpr size_t packed_layout<type_list<Ts...> >::_sizes[];
+
+template <typename... Ts>
+constexpr size_t packed_layout<type_list<Ts...> >::_alignments[];
+
+/**
+ * Storage for the slots of a packed layout, nested one slot per level.
+ * Each level is at least as aligned as the next, so nesting adds no
+ * padding over a flat struct with the same member order.
+ */
+template <typename Layout, unsigned int P = 0,
+    bool Last = (P + 1 == Layout::size)>
+struct packed_storage
+{
+    typename Layout::template slot_type<P>::type head;
+    packed_storage<Layout, P + 1> tail;
+};
+
+template <typename Layout, unsigned int P>
+struct packed_storage<Layout, P, true>
+{
+    typename Layout::template slot_type<P>::type head;
+};
+
+namespace detail {
+
+template <typename Layout, unsigned int P, unsigned int D>
+struct packed_getter
+{
+    typedef typename Layout::template slot_type<P>::type type;
+
+    static type& get(packed_storage<Layout, D>& storage)
+    {
+        return packed_getter<Layout, P, D + 1>::get(storage.tail);
+    }
+
+    static const type& get(const packed_storage<Layout, D>& storage)
+    {
+        return packed_getter<Layout, P, D + 1>::get(storage.tail);
+    }
+};
+
+template <typename Layout, unsigned int P>
+struct packed_getter<Layout, P, P>
+{
+    typedef typename Layout::template slot_type<P>::type type;
+
+    static type& get(packed_storage<Layout, P>& storage)
+    {
+        return storage.head;
+    }
+
+    static const type& get(const packed_storage<Layout, P>& storage)
+    {
+        return storage.head;
+    }
+};
+
+}
+
+/**
+ * Access the slot P of a packed storage.
+ */
+template <unsigned int P, typename Layout>
+typename Layout::template slot_type<P>::type& packed_get(
+    packed_storage<Layout>& storage)
+{
+    return detail::packed_getter<Layout, P, 0>::get(storage);
+}
+
+template <unsigned int P, typename Layout>
+const typename Layout::template slot_type<P>::type& packed_get(
+    const packed_storage<Layout>& storage)
+{
+    return detail::packed_getter<Layout, P, 0>::get(storage);
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace f1d {
+
+/**
+ * Factory policy that validates the begin-set-end-get cycle and throws
+ * on any misuse.
+ */
+struct checked_factory
+{
+    static const bool checked = true;
+};
+
+/**
+ * Factory policy that performs no validation at all, setters become
+ * plain member stores. Misusing the factory is undefined behavior.
+ */
+struct unchecked_factory
+{
+    static const bool checked = false;
+};
+
+}
+
+/**
+ * Policy used by the Name_factory typedefs. Defining F1D_UNCHECKED_FACTORY
+ * switches the default to unchecked_factory, which must be done
+ * consistently across every translation unit of the program.
+ */
+#ifndef F1D_DEFAULT_FACTORY_POLICY
+#ifdef F1D_UNCHECKED_FACTORY
+#define F1D_DEFAULT_FACTORY_POLICY f1d::unchecked_factory
+#else
+#define F1D_DEFAULT_FACTORY_POLICY f1d::checked_factory
+#endif
+#endif
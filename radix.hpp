@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "field_reader.hpp"
+
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace f1d {
+
+/**
+ * Maps a key to an unsigned integer with the same order, so it can be
+ * sorted byte by byte. Signed integers have the sign bit flipped and
+ * floating point numbers are ordered by their bits, with -0.0 before
+ * 0.0 and NaNs at the ends. Specialize for other key types.
+ */
+template <typename T, typename Enable = void>
+struct radix_key
+{
+    static_assert(sizeof(T) == 0,
+        "f1d::radix_key must be specialized for this key type");
+};
+
+template <typename T>
+struct radix_key<T, typename std::enable_if<
+    std::is_integral<T>::value && std::is_unsigned<T>::value>::type>
+{
+    typedef T type;
+
+    static type get(T value)
+    {
+        return value;
+    }
+};
+
+template <typename T>
+struct radix_key<T, typename std::enable_if<
+    std::is_integral<T>::value && std::is_signed<T>::value>::type>
+{
+    typedef typename std::make_unsigned<T>::type type;
+
+    static type get(T value)
+    {
+        return static_cast<type>(value) ^
+            static_cast<type>(type(1) << (sizeof(T) * 8 - 1));
+    }
+};
+
+template <typename T>
+struct radix_key<T, typename std::enable_if<std::is_enum<T>::value>::type> :
+    radix_key<typename std::underlying_type<T>::type>
+{
+    typedef radix_key<typename std::underlying_type<T>::type> base_type;
+
+    static typename base_type::type get(T value)
+    {
+        return base_type::get(
+            static_cast<typename std::underlying_type<T>::type>(value));
+    }
+};
+
+template <typename T>
+struct radix_key<T, typename std::enable_if<
+    std::is_floating_point<T>::value &&
+    (sizeof(T) == 4 || sizeof(T) == 8)>::type>
+{
+    typedef typename std::conditional<sizeof(T) == 4,
+        boost::uint32_t, boost::uint64_t>::type type;
+
+    static type get(T value)
+    {
+        const type sign = type(1) << (sizeof(T) * 8 - 1);
+
+        type bits;
+        std::memcpy(&bits, &value, sizeof(T));
+
+        return (bits & sign) ? ~bits : (bits | sign);
+    }
+};
+
+namespace detail {
+
+/**
+ * Stable LSD radix sort of the keys, one byte per pass, applying the same
+ * moves to the order. Passes where every key has the same byte are
+ * skipped.
+ */
+template <typename K>
+void radix_sort_keys(std::vector<K>& keys, std::vector<size_t>& order)
+{
+    const size_t n = keys.size();
+    const unsigned int passes = sizeof(K);
+
+    if (n < 2)
+        return;
+
+    std::vector<size_t> counts(passes * 256, 0);
+
+    for (size_t i = 0; i < n; i++)
+        for (unsigned int p = 0; p < passes; p++)
+            counts[p * 256 + ((keys[i] >> (p * 8)) & 0xFF)]++;
+
+    std::vector<K> sorted_keys(n);
+    std::vector<size_t> sorted_order(n);
+
+    for (unsigned int p = 0; p < passes; p++) {
+
+        size_t* offsets = &counts[p * 256];
+
+        if (offsets[(keys[0] >> (p * 8)) & 0xFF] == n)
+            continue;
+
+        size_t total = 0;
+
+        for (unsigned int b = 0; b < 256; b++) {
+            const size_t count = offsets[b];
+            offsets[b] = total;
+            total += count;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            const size_t j = offsets[(keys[i] >> (p * 8)) & 0xFF]++;
+            sorted_keys[j] = keys[i];
+            sorted_order[j] = order[i];
+        }
+
+        keys.swap(sorted_keys);
+        order.swap(sorted_order);
+    }
+}
+
+template <typename... Fields>
+struct radix_sorter;
+
+template <>
+struct radix_sorter<>
+{
+    template <typename Container>
+    static void sort(const Container&, std::vector<size_t>&)
+    {
+    }
+};
+
+template <typename Field, typename... Fields>
+struct radix_sorter<Field, Fields...>
+{
+    template <typename Container>
+    static void sort(const Container& c, std::vector<size_t>& order)
+    {
+        // LSD: the least significant keys are sorted first
+        radix_sorter<Fields...>::sort(c, order);
+
+        typedef radix_key<typename Field::value_type> key;
+
+        field_reader<Field, Container> read(c);
+        std::vector<typename key::type> keys(order.size());
+
+        for (size_t i = 0; i < order.size(); i++)
+            keys[i] = key::get(read(order[i]));
+
+        radix_sort_keys(keys, order);
+    }
+};
+
+struct column_permuter
+{
+    const std::vector<size_t>& order;
+
+    column_permuter(const std::vector<size_t>& order) :
+        order(order)
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(V& column)
+    {
+        using std::swap;
+
+        V sorted;
+        sorted.resize(order.size());
+
+        for (size_t i = 0; i < order.size(); i++)
+            swap(sorted[i], column[order[i]]);
+
+        column.swap(sorted);
+    }
+};
+
+template <typename Container>
+void radix_permute(Container& c, const std::vector<size_t>& order)
+{
+    column_permuter f(order);
+    c.apply(f);
+}
+
+template <typename S, typename A>
+void radix_permute(std::vector<S, A>& v, const std::vector<size_t>& order)
+{
+    std::vector<S, A> sorted(v.get_allocator());
+    sorted.reserve(order.size());
+
+    for (size_t i = 0; i < order.size(); i++)
+        sorted.push_back(std::move(v[order[i]]));
+
+    v.swap(sorted);
+}
+
+}
+
+/**
+ * Stable radix sort permutation of a vector of f1d structs or of an SoA
+ * container, by one or more keys given as field wrappers, most
+ * significant first, e.g. radix_sort_permutation<types::a_f>(v, order).
+ * On return, order[i] is the index of the element that goes to the i-th
+ * position. The container is not modified.
+ */
+template <typename... Fields, typename Container>
+void radix_sort_permutation(const Container& c, std::vector<size_t>& order)
+{
+    static_assert(sizeof...(Fields) > 0, "no sort key given");
+
+    order.resize(c.size());
+
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+
+    detail::radix_sorter<Fields...>::sort(c, order);
+}
+
+/**
+ * Stable radix sort of a vector of f1d structs or of an SoA container by
+ * one or more keys given as field wrappers, most significant first. The
+ * records are moved once, after the permutation is computed.
+ */
+template <typename... Fields, typename Container>
+void radix_sort(Container& c)
+{
+    std::vector<size_t> order;
+    radix_sort_permutation<Fields...>(c, order);
+    detail::radix_permute(c, order);
+}
+
+}
@@ -0,0 +1,593 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "exceptions.hpp"
+#include "hash.hpp"
+#include "type_list.hpp"
+
+#include <boost/cstdint.hpp>
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace f1d {
+
+/**
+ * Physical layout of the records stored in a record file.
+ */
+enum record_layout
+{
+    aos_layout = 0,
+    soa_layout = 1
+};
+
+namespace detail {
+
+static const char record_file_magic[8] = {
+    'F', '1', 'D', 'R', 'E', 'C', '\0', '\0'
+};
+
+static const boost::uint32_t record_file_version = 1;
+static const boost::uint32_t record_file_byte_order = 0x01020304;
+static const size_t record_file_alignment = 64;
+static const size_t record_file_buffer_size = 64 * 1024;
+
+inline size_t record_file_align(size_t offset)
+{
+    return (offset + record_file_alignment - 1) /
+        record_file_alignment * record_file_alignment;
+}
+
+template <typename T>
+void record_file_put(std::vector<char>& out, const T& value)
+{
+    const char* p = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+inline void record_file_put_string(std::vector<char>& out, const char* str)
+{
+    const boost::uint32_t length = std::strlen(str);
+    record_file_put(out, length);
+    out.insert(out.end(), str, str + length);
+}
+
+/**
+ * Sequential reader over the header bytes, returns false instead of
+ * reading past the end of the mapped file.
+ */
+class record_file_cursor
+{
+private:
+
+    const char* _pos;
+    const char* _end;
+
+public:
+
+    record_file_cursor(const char* begin, const char* end) :
+        _pos(begin),
+        _end(end)
+    {
+    }
+
+    template <typename T>
+    bool get(T& value)
+    {
+        if (static_cast<size_t>(_end - _pos) < sizeof(T))
+            return false;
+
+        std::memcpy(&value, _pos, sizeof(T));
+        _pos += sizeof(T);
+        return true;
+    }
+
+    bool get_string(std::string& value)
+    {
+        boost::uint32_t length;
+
+        if (!get(length) || static_cast<size_t>(_end - _pos) < length)
+            return false;
+
+        value.assign(_pos, length);
+        _pos += length;
+        return true;
+    }
+};
+
+/**
+ * Build the header describing the struct S and its data section.
+ */
+template <typename S>
+std::vector<char> make_record_file_header(
+    record_layout layout,
+    boost::uint64_t count)
+{
+    std::vector<char> header(record_file_magic, record_file_magic + 8);
+
+    record_file_put(header, record_file_version);
+    record_file_put(header, record_file_byte_order);
+    record_file_put(header, static_cast<boost::uint32_t>(layout));
+    record_file_put(header, static_cast<boost::uint32_t>(S::num_fields));
+    record_file_put(header, count);
+    record_file_put(header, static_cast<boost::uint64_t>(sizeof(S)));
+
+    record_file_put_string(header, S::get_struct_name());
+
+    for (unsigned int i = 0; i < S::num_fields; i++) {
+        record_file_put_string(header, S::get_field_names()[i]);
+        record_file_put_string(header, S::get_type_names()[i]);
+        record_file_put(header,
+            static_cast<boost::uint64_t>(S::get_type_sizes()[i]));
+    }
+
+    header.resize(record_file_align(header.size()), '\0');
+    return header;
+}
+
+/**
+ * Offset of each column, relative to the data section, for SoA files.
+ */
+template <typename S>
+std::vector<size_t> soa_column_offsets(size_t count)
+{
+    std::vector<size_t> offsets(S::num_fields);
+    size_t offset = 0;
+
+    for (unsigned int i = 0; i < S::num_fields; i++) {
+        offsets[i] = offset;
+        offset = record_file_align(offset + count * S::get_type_sizes()[i]);
+    }
+
+    return offsets;
+}
+
+inline void record_file_pad(std::ofstream& out, size_t bytes)
+{
+    const char zeros[record_file_alignment] = { 0 };
+    out.write(zeros, record_file_align(bytes) - bytes);
+}
+
+struct soa_column_writer
+{
+    std::ofstream& out;
+    size_t written;
+
+    soa_column_writer(std::ofstream& out) :
+        out(out),
+        written(0)
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V& column)
+    {
+        const size_t bytes = column.size() * sizeof(typename V::value_type);
+
+        out.write(reinterpret_cast<const char*>(column.data()), bytes);
+        record_file_pad(out, bytes);
+        written += record_file_align(bytes);
+    }
+};
+
+template <typename S, typename Indices>
+struct soa_range_writer;
+
+/**
+ * Write the records of a range as SoA columns, one pass over the range
+ * per column, staging the values in a bounded buffer so the memory used
+ * does not grow with the number of records.
+ */
+template <typename S, unsigned int... Is>
+struct soa_range_writer<S, index_list<Is...> >
+{
+    template <unsigned int I, typename Iterator>
+    static int write_column(std::ofstream& out, std::vector<char>& buffer,
+        Iterator first, Iterator last)
+    {
+        typedef typename type_at<I, typename S::field_types>::type T;
+
+        size_t used = 0;
+        size_t bytes = 0;
+
+        for (; first != last; ++first) {
+
+            if (buffer.size() - used < sizeof(T)) {
+                out.write(&buffer[0], used);
+                used = 0;
+            }
+
+            const S& obj = *first;
+            std::memcpy(&buffer[used], &field_at<S, I>(obj), sizeof(T));
+            used += sizeof(T);
+            bytes += sizeof(T);
+        }
+
+        out.write(&buffer[0], used);
+        record_file_pad(out, bytes);
+
+        return 0;
+    }
+
+    template <typename Iterator>
+    static void write(std::ofstream& out, Iterator first, Iterator last)
+    {
+        std::vector<char> buffer(std::max(record_file_buffer_size,
+            sizeof(S)));
+
+        const int expand[] = { 0,
+            write_column<Is>(out, buffer, first, last)... };
+        (void)expand;
+    }
+};
+
+inline void record_file_open_failed(const std::string& path, int error)
+{
+    F1D_THROW(io_exception()
+        << boost::errinfo_file_name(path)
+        << boost::errinfo_errno(error));
+}
+
+}
+
+/**
+ * Write the records in [first, last) to a record file. The range is
+ * traversed once to count the records and, for the SoA layout, once more
+ * per column, so it must be a forward range.
+ */
+template <typename Iterator>
+void write_record_file(
+    const std::string& path,
+    Iterator first,
+    Iterator last,
+    record_layout layout = aos_layout)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type S;
+
+    static_assert(std::is_trivially_copyable<S>::value,
+        "record files require trivially copyable structs");
+
+    static_assert(std::is_base_of<std::forward_iterator_tag,
+        typename std::iterator_traits<Iterator>::iterator_category>::value,
+        "record files are written from forward iterators");
+
+    const size_t count = std::distance(first, last);
+    const std::vector<char> header =
+        detail::make_record_file_header<S>(layout, count);
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+
+    if (!out)
+        detail::record_file_open_failed(path, errno);
+
+    out.write(&header[0], header.size());
+
+    if (layout == aos_layout) {
+        for (; first != last; ++first) {
+            const S& obj = *first;
+            out.write(reinterpret_cast<const char*>(&obj), sizeof(S));
+        }
+    }
+    else {
+        detail::soa_range_writer<S,
+            typename make_index_list<S::num_fields>::type>::write(
+            out, first, last);
+    }
+
+    if (!out)
+        detail::record_file_open_failed(path, errno);
+}
+
+/**
+ * Write the columns of a container generated by F1D_SOA_MAKE to a
+ * record file with the SoA layout.
+ */
+template <typename SoA>
+void write_record_file(
+    const std::string& path,
+    const SoA& soa)
+{
+    typedef typename SoA::value_type S;
+
+    static_assert(std::is_trivially_copyable<S>::value,
+        "record files require trivially copyable structs");
+
+    const std::vector<char> header =
+        detail::make_record_file_header<S>(soa_layout, soa.size());
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+
+    if (!out)
+        detail::record_file_open_failed(path, errno);
+
+    out.write(&header[0], header.size());
+
+    detail::soa_column_writer f(out);
+    soa.capply(f);
+
+    if (!out)
+        detail::record_file_open_failed(path, errno);
+}
+
+/**
+ * Read-only, memory-mapped view over a record file. The header is
+ * validated against the metadata of S and the records are accessed in
+ * place, without copies.
+ *
+ * The record range (data, begin, end and operator []) is only valid for
+ * AoS files and the columns are only valid for SoA files, accessing the
+ * other layout throws format_exception.
+ */
+template <typename S>
+class record_file
+{
+    static_assert(std::is_trivially_copyable<S>::value,
+        "record files require trivially copyable structs");
+
+public:
+
+    typedef S value_type;
+    typedef const S* const_iterator;
+
+private:
+
+    void* _map;
+    size_t _map_size;
+    std::string _path;
+    record_layout _layout;
+    size_t _size;
+    const char* _data;
+    std::vector<size_t> _offsets;
+
+    void format_error(const char* what) const
+    {
+        F1D_THROW(format_exception()
+            << struct_name(S::get_struct_name())
+            << boost::errinfo_file_name(_path)
+            << header_field(what));
+    }
+
+    void check_layout(record_layout expected) const
+    {
+        if (_layout != expected)
+            format_error("layout");
+    }
+
+    void check_string(detail::record_file_cursor& cursor,
+        const char* expected, const char* what) const
+    {
+        std::string value;
+
+        if (!cursor.get_string(value) || value != expected)
+            format_error(what);
+    }
+
+    template <typename T>
+    void check_value(detail::record_file_cursor& cursor,
+        T expected, const char* what) const
+    {
+        T value;
+
+        if (!cursor.get(value) || value != expected)
+            format_error(what);
+    }
+
+    void validate()
+    {
+        const char* begin = static_cast<const char*>(_map);
+        detail::record_file_cursor cursor(begin, begin + _map_size);
+
+        char magic[8];
+
+        if (!cursor.get(magic) ||
+            std::memcmp(magic, detail::record_file_magic, 8) != 0)
+            format_error("magic");
+
+        check_value(cursor, detail::record_file_version, "version");
+        check_value(cursor, detail::record_file_byte_order, "byte_order");
+
+        boost::uint32_t layout;
+        boost::uint64_t count;
+
+        if (!cursor.get(layout) || layout > soa_layout)
+            format_error("layout");
+
+        check_value(cursor, static_cast<boost::uint32_t>(S::num_fields),
+            "num_fields");
+
+        if (!cursor.get(count))
+            format_error("count");
+
+        check_value(cursor, static_cast<boost::uint64_t>(sizeof(S)),
+            "record_size");
+        check_string(cursor, S::get_struct_name(), "struct_name");
+
+        for (unsigned int i = 0; i < S::num_fields; i++) {
+            check_string(cursor, S::get_field_names()[i], "field_names");
+            check_string(cursor, S::get_type_names()[i], "type_names");
+            check_value(cursor,
+                static_cast<boost::uint64_t>(S::get_type_sizes()[i]),
+                "type_sizes");
+        }
+
+        const std::vector<char> header =
+            detail::make_record_file_header<S>(
+                static_cast<record_layout>(layout), count);
+
+        if (_map_size < header.size())
+            format_error("data_size");
+
+        _layout = static_cast<record_layout>(layout);
+
+        // Check the count before multiplying so the sizes below cannot
+        // wrap, SoA columns have no padding between records
+        const size_t available = _map_size - header.size();
+        const size_t record_size = _layout == soa_layout ?
+            S::packed_size : sizeof(S);
+
+        if (count > available / record_size)
+            format_error("count");
+
+        _size = static_cast<size_t>(count);
+        _data = begin + header.size();
+
+        if (_layout == soa_layout) {
+            _offsets = detail::soa_column_offsets<S>(_size);
+
+            for (unsigned int i = 0; i < S::num_fields; i++) {
+                if (_offsets[i] > available || available - _offsets[i] <
+                    _size * S::get_type_sizes()[i])
+                    format_error("data_size");
+            }
+        }
+    }
+
+    void close()
+    {
+        if (_map != 0)
+            munmap(_map, _map_size);
+
+        _map = 0;
+    }
+
+public:
+
+    explicit record_file(const std::string& path) :
+        _map(0),
+        _map_size(0),
+        _path(path),
+        _layout(aos_layout),
+        _size(0),
+        _data(0),
+        _offsets()
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            detail::record_file_open_failed(path, errno);
+
+        struct stat st;
+
+        // Save errno before close, which may overwrite it
+        if (fstat(fd, &st) != 0) {
+            const int error = errno;
+            ::close(fd);
+            detail::record_file_open_failed(path, error);
+        }
+
+        _map_size = static_cast<size_t>(st.st_size);
+
+        if (_map_size != 0) {
+            _map = mmap(0, _map_size, PROT_READ, MAP_SHARED, fd, 0);
+
+            if (_map == MAP_FAILED) {
+                const int error = errno;
+                _map = 0;
+                ::close(fd);
+                detail::record_file_open_failed(path, error);
+            }
+        }
+
+        ::close(fd);
+
+        try {
+            validate();
+        }
+        catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    record_file(const record_file&) = delete;
+    record_file& operator =(const record_file&) = delete;
+
+    ~record_file()
+    {
+        close();
+    }
+
+    record_layout layout() const
+    {
+        return _layout;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    const S* data() const
+    {
+        check_layout(aos_layout);
+        return reinterpret_cast<const S*>(_data);
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + _size;
+    }
+
+    const S& operator [](size_t i) const
+    {
+        return data()[i];
+    }
+
+    /**
+     * Pointer to the column of the field represented by the field
+     * wrapper type Field, which must be a wrapper of S.
+     */
+    template <typename Field>
+    typename std::enable_if<
+        std::is_same<typename Field::struct_type, S>::value,
+        const typename Field::value_type*>::type
+    column() const
+    {
+        check_layout(soa_layout);
+        return reinterpret_cast<const typename Field::value_type*>(
+            _data + _offsets[Field::index]);
+    }
+};
+
+}
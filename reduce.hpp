@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "exceptions.hpp"
+#include "field_reader.hpp"
+#include "selection.hpp"
+
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace f1d {
+
+/**
+ * Type used to accumulate the sum of a field: 64-bit integers for
+ * integral fields and at least double for floating point fields.
+ */
+template <typename T, typename Enable = void>
+struct sum_type
+{
+    typedef T type;
+};
+
+template <typename T>
+struct sum_type<T, typename std::enable_if<
+    std::is_integral<T>::value && std::is_signed<T>::value>::type>
+{
+    typedef boost::int64_t type;
+};
+
+template <typename T>
+struct sum_type<T, typename std::enable_if<
+    std::is_integral<T>::value && std::is_unsigned<T>::value>::type>
+{
+    typedef boost::uint64_t type;
+};
+
+template <>
+struct sum_type<float>
+{
+    typedef double type;
+};
+
+namespace detail {
+
+/*
+ * The kernels keep four independent accumulators, so the loops have no
+ * dependency between consecutive elements and can be vectorized over SoA
+ * columns or unrolled over the fixed stride of a vector of structs.
+ */
+
+template <typename Acc, typename Reader>
+Acc sum(const Reader& read, size_t n)
+{
+    Acc a0 = Acc(), a1 = Acc(), a2 = Acc(), a3 = Acc();
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        a0 += read(i);
+        a1 += read(i + 1);
+        a2 += read(i + 2);
+        a3 += read(i + 3);
+    }
+
+    for (; i < n; i++)
+        a0 += read(i);
+
+    return (a0 + a1) + (a2 + a3);
+}
+
+template <typename T, typename Reader, typename Better>
+T extreme(const Reader& read, size_t n, Better better)
+{
+    T m0 = read(0), m1 = m0, m2 = m0, m3 = m0;
+    size_t i = 1;
+
+    for (; i + 4 <= n; i += 4) {
+        m0 = better(read(i), m0) ? read(i) : m0;
+        m1 = better(read(i + 1), m1) ? read(i + 1) : m1;
+        m2 = better(read(i + 2), m2) ? read(i + 2) : m2;
+        m3 = better(read(i + 3), m3) ? read(i + 3) : m3;
+    }
+
+    for (; i < n; i++)
+        m0 = better(read(i), m0) ? read(i) : m0;
+
+    m0 = better(m1, m0) ? m1 : m0;
+    m2 = better(m3, m2) ? m3 : m2;
+
+    return better(m2, m0) ? m2 : m0;
+}
+
+struct less
+{
+    template <typename T>
+    bool operator ()(const T& a, const T& b) const
+    {
+        return a < b;
+    }
+};
+
+struct greater
+{
+    template <typename T>
+    bool operator ()(const T& a, const T& b) const
+    {
+        return b < a;
+    }
+};
+
+template <typename T, typename Reader, typename Better>
+error_code try_extreme(const Reader& read, size_t n, T& value, Better better)
+{
+    if (n == 0)
+        return not_found_error;
+
+    value = extreme<T>(read, n, better);
+    return no_error;
+}
+
+template <typename Reader, typename Predicate>
+size_t count_if(const Reader& read, size_t n, Predicate pred)
+{
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        c0 += pred(read(i)) ? 1 : 0;
+        c1 += pred(read(i + 1)) ? 1 : 0;
+        c2 += pred(read(i + 2)) ? 1 : 0;
+        c3 += pred(read(i + 3)) ? 1 : 0;
+    }
+
+    for (; i < n; i++)
+        c0 += pred(read(i)) ? 1 : 0;
+
+    return (c0 + c1) + (c2 + c3);
+}
+
+template <typename Container>
+void throw_empty(const Container&)
+{
+    F1D_THROW(not_found_exception()
+        << struct_name(Container::value_type::get_struct_name()));
+}
+
+}
+
+/**
+ * Sum of a field over a vector of structs or an SoA container, given as
+ * a field wrapper, e.g. sum<types::price_f>(orders).
+ */
+template <typename Field, typename Container>
+typename sum_type<typename Field::value_type>::type sum(const Container& c)
+{
+    typedef typename sum_type<typename Field::value_type>::type acc_type;
+
+    return detail::sum<acc_type>(
+        detail::field_reader<Field, Container>(c), c.size());
+}
+
+template <typename Field, typename Container>
+error_code try_min(const Container& c, typename Field::value_type& value)
+{
+    return detail::try_extreme(detail::field_reader<Field, Container>(c),
+        c.size(), value, detail::less());
+}
+
+template <typename Field, typename Container>
+error_code try_max(const Container& c, typename Field::value_type& value)
+{
+    return detail::try_extreme(detail::field_reader<Field, Container>(c),
+        c.size(), value, detail::greater());
+}
+
+/**
+ * Smallest value of a field. Throws not_found_exception when the
+ * container is empty.
+ */
+template <typename Field, typename Container>
+typename Field::value_type min(const Container& c)
+{
+    typename Field::value_type value;
+
+    if (try_min<Field>(c, value) != no_error)
+        detail::throw_empty(c);
+
+    return value;
+}
+
+/**
+ * Largest value of a field. Throws not_found_exception when the
+ * container is empty.
+ */
+template <typename Field, typename Container>
+typename Field::value_type max(const Container& c)
+{
+    typename Field::value_type value;
+
+    if (try_max<Field>(c, value) != no_error)
+        detail::throw_empty(c);
+
+    return value;
+}
+
+template <typename Field, typename Container>
+error_code try_mean(const Container& c, double& value)
+{
+    if (c.size() == 0)
+        return not_found_error;
+
+    value = static_cast<double>(sum<Field>(c)) / c.size();
+    return no_error;
+}
+
+/**
+ * Arithmetic mean of a field. Throws not_found_exception when the
+ * container is empty.
+ */
+template <typename Field, typename Container>
+double mean(const Container& c)
+{
+    double value;
+
+    if (try_mean<Field>(c, value) != no_error)
+        detail::throw_empty(c);
+
+    return value;
+}
+
+/**
+ * Number of elements whose field satisfies the predicate.
+ */
+template <typename Field, typename Container, typename Predicate>
+size_t count_if(const Container& c, Predicate pred)
+{
+    return detail::count_if(detail::field_reader<Field, Container>(c),
+        c.size(), pred);
+}
+
+/*
+ * Reductions over the rows of a selection, reading only the selected
+ * rows of the container.
+ */
+
+template <typename Field, typename Container>
+typename sum_type<typename Field::value_type>::type sum(const Container& c,
+    const selection& rows)
+{
+    typedef typename sum_type<typename Field::value_type>::type acc_type;
+    typedef detail::field_reader<Field, Container> reader_type;
+
+    const reader_type read(c);
+
+    return detail::sum<acc_type>(
+        detail::selected_reader<reader_type>(read, rows), rows.size());
+}
+
+template <typename Field, typename Container>
+error_code try_min(const Container& c, const selection& rows,
+    typename Field::value_type& value)
+{
+    typedef detail::field_reader<Field, Container> reader_type;
+
+    const reader_type read(c);
+
+    return detail::try_extreme(detail::selected_reader<reader_type>(read,
+        rows), rows.size(), value, detail::less());
+}
+
+template <typename Field, typename Container>
+error_code try_max(const Container& c, const selection& rows,
+    typename Field::value_type& value)
+{
+    typedef detail::field_reader<Field, Container> reader_type;
+
+    const reader_type read(c);
+
+    return detail::try_extreme(detail::selected_reader<reader_type>(read,
+        rows), rows.size(), value, detail::greater());
+}
+
+template <typename Field, typename Container>
+typename Field::value_type min(const Container& c, const selection& rows)
+{
+    typename Field::value_type value;
+
+    if (try_min<Field>(c, rows, value) != no_error)
+        detail::throw_empty(c);
+
+    return value;
+}
+
+template <typename Field, typename Container>
+typename Field::value_type max(const Container& c, const selection& rows)
+{
+    typename Field::value_type value;
+
+    if (try_max<Field>(c, rows, value) != no_error)
+        detail::throw_empty(c);
+
+    return value;
+}
+
+template <typename Field, typename Container>
+error_code try_mean(const Container& c, const selection& rows,
+    double& value)
+{
+    if (rows.empty())
+        return not_found_error;
+
+    value = static_cast<double>(sum<Field>(c, rows)) / rows.size();
+    return no_error;
+}
+
+template <typename Field, typename Container>
+double mean(const Container& c, const selection& rows)
+{
+    double value;
+
+    if (try_mean<Field>(c, rows, value) != no_error)
+        detail::throw_empty(c);
+
+    return value;
+}
+
+template <typename Field, typename Container, typename Predicate>
+size_t count_if(const Container& c, const selection& rows, Predicate pred)
+{
+    typedef detail::field_reader<Field, Container> reader_type;
+
+    const reader_type read(c);
+
+    return detail::count_if(detail::selected_reader<reader_type>(read, rows),
+        rows.size(), pred);
+}
+
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace f1d {
+
+/**
+ * Rows of a container selected by a filter, in increasing order.
+ */
+typedef std::vector<size_t> selection;
+
+namespace detail {
+
+inline unsigned int popcount(boost::uint64_t word)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    unsigned int count = 0;
+
+    for (; word != 0; word &= word - 1)
+        count++;
+
+    return count;
+#endif
+}
+
+inline unsigned int count_trailing_zeros(boost::uint64_t word)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    unsigned int count = 0;
+
+    for (; (word & 1) == 0; word >>= 1)
+        count++;
+
+    return count;
+#endif
+}
+
+/**
+ * Reader over the selected rows of another reader, so the reduction
+ * kernels can consume a selection without copying the rows.
+ */
+template <typename Reader>
+class selected_reader
+{
+private:
+
+    const Reader& _read;
+    const size_t* _rows;
+
+public:
+
+    selected_reader(const Reader& read, const selection& rows) :
+        _read(read),
+        _rows(rows.data())
+    {
+    }
+
+    auto operator ()(size_t i) const -> decltype(_read(0))
+    {
+        return _read(_rows[i]);
+    }
+};
+
+}
+
+/**
+ * One bit per row of a container, set for the selected rows. Bitmaps
+ * over the same rows can be combined with & and |.
+ */
+class selection_bitmap
+{
+private:
+
+    std::vector<boost::uint64_t> _words;
+    size_t _size;
+
+public:
+
+    static const size_t word_bits = 64;
+
+    explicit selection_bitmap(size_t size = 0) :
+        _words((size + word_bits - 1) / word_bits, 0),
+        _size(size)
+    {
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     * Resize the bitmap to size rows, all of them unselected.
+     */
+    void reset(size_t size)
+    {
+        _words.assign((size + word_bits - 1) / word_bits, 0);
+        _size = size;
+    }
+
+    boost::uint64_t* words()
+    {
+        return _words.data();
+    }
+
+    const boost::uint64_t* words() const
+    {
+        return _words.data();
+    }
+
+    size_t num_words() const
+    {
+        return _words.size();
+    }
+
+    bool test(size_t row) const
+    {
+        return (_words[row / word_bits] >> (row % word_bits)) & 1;
+    }
+
+    void set(size_t row, bool value = true)
+    {
+        const boost::uint64_t bit = boost::uint64_t(1) << (row % word_bits);
+
+        if (value)
+            _words[row / word_bits] |= bit;
+        else
+            _words[row / word_bits] &= ~bit;
+    }
+
+    /**
+     * Number of selected rows.
+     */
+    size_t count() const
+    {
+        size_t total = 0;
+
+        for (size_t i = 0; i < _words.size(); i++)
+            total += detail::popcount(_words[i]);
+
+        return total;
+    }
+
+    selection_bitmap& operator &=(const selection_bitmap& other)
+    {
+        for (size_t i = 0; i < _words.size() && i < other._words.size(); i++)
+            _words[i] &= other._words[i];
+
+        for (size_t i = other._words.size(); i < _words.size(); i++)
+            _words[i] = 0;
+
+        return *this;
+    }
+
+    selection_bitmap& operator |=(const selection_bitmap& other)
+    {
+        for (size_t i = 0; i < _words.size() && i < other._words.size(); i++)
+            _words[i] |= other._words[i];
+
+        return *this;
+    }
+
+    /**
+     * Rows of the set bits, in increasing order.
+     */
+    void to_selection(selection& out) const
+    {
+        out.clear();
+        out.reserve(count());
+
+        for (size_t i = 0; i < _words.size(); i++)
+            for (boost::uint64_t w = _words[i]; w != 0; w &= w - 1)
+                out.push_back(i * word_bits + detail::count_trailing_zeros(w));
+    }
+};
+
+inline selection_bitmap operator &(selection_bitmap a,
+    const selection_bitmap& b)
+{
+    return a &= b;
+}
+
+inline selection_bitmap operator |(selection_bitmap a,
+    const selection_bitmap& b)
+{
+    return a |= b;
+}
+
+}
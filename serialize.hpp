@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "exceptions.hpp"
+
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace f1d {
+
+/**
+ * Wire representation of a single field. Values are written in native
+ * byte order. The default implementation copies the bytes of trivially
+ * copyable types, other types must specialize this template.
+ */
+template <typename T, typename Enable = void>
+struct serializer
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+        "f1d::serializer must be specialized for this field type");
+
+    static size_t size(const T&)
+    {
+        return sizeof(T);
+    }
+
+    static char* write(const T& value, char* out)
+    {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+
+    static const char* read(T& value, const char* in, const char* end)
+    {
+        if (static_cast<size_t>(end - in) < sizeof(T))
+            return 0;
+
+        std::memcpy(&value, in, sizeof(T));
+        return in + sizeof(T);
+    }
+};
+
+/**
+ * Length-prefixed byte representation for strings.
+ */
+template <typename C, typename Tr, typename A>
+struct serializer<std::basic_string<C, Tr, A> >
+{
+    typedef std::basic_string<C, Tr, A> string_type;
+
+    static size_t size(const string_type& value)
+    {
+        return sizeof(boost::uint64_t) + value.size() * sizeof(C);
+    }
+
+    static char* write(const string_type& value, char* out)
+    {
+        const boost::uint64_t length = value.size();
+        out = serializer<boost::uint64_t>::write(length, out);
+        std::memcpy(out, value.data(), value.size() * sizeof(C));
+        return out + value.size() * sizeof(C);
+    }
+
+    static const char* read(string_type& value, const char* in,
+        const char* end)
+    {
+        boost::uint64_t length;
+
+        in = serializer<boost::uint64_t>::read(length, in, end);
+
+        if (in == 0 || static_cast<size_t>(end - in) / sizeof(C) < length)
+            return 0;
+
+        value.assign(reinterpret_cast<const C*>(in),
+            static_cast<size_t>(length));
+
+        return in + length * sizeof(C);
+    }
+};
+
+/**
+ * Count-prefixed representation for vectors, copied in bulk when the
+ * elements are trivially copyable.
+ */
+template <typename T, typename A>
+struct serializer<std::vector<T, A> >
+{
+    typedef std::vector<T, A> vector_type;
+
+    static const bool bulk = std::is_trivially_copyable<T>::value;
+
+    typedef std::integral_constant<bool, bulk> bulk_type;
+
+    static size_t size(const vector_type& value, std::true_type)
+    {
+        return sizeof(boost::uint64_t) + value.size() * sizeof(T);
+    }
+
+    static size_t size(const vector_type& value, std::false_type)
+    {
+        size_t total = sizeof(boost::uint64_t);
+
+        for (size_t i = 0; i < value.size(); i++)
+            total += serializer<T>::size(value[i]);
+
+        return total;
+    }
+
+    static size_t size(const vector_type& value)
+    {
+        return size(value, bulk_type());
+    }
+
+    static char* write(const vector_type& value, char* out, std::true_type)
+    {
+        if (!value.empty())
+            std::memcpy(out, value.data(), value.size() * sizeof(T));
+
+        return out + value.size() * sizeof(T);
+    }
+
+    static char* write(const vector_type& value, char* out, std::false_type)
+    {
+        for (size_t i = 0; i < value.size(); i++)
+            out = serializer<T>::write(value[i], out);
+
+        return out;
+    }
+
+    static char* write(const vector_type& value, char* out)
+    {
+        const boost::uint64_t count = value.size();
+        out = serializer<boost::uint64_t>::write(count, out);
+        return write(value, out, bulk_type());
+    }
+
+    static const char* read(vector_type& value, boost::uint64_t count,
+        const char* in, const char* end, std::true_type)
+    {
+        if (static_cast<size_t>(end - in) / sizeof(T) < count)
+            return 0;
+
+        value.resize(static_cast<size_t>(count));
+
+        if (count != 0)
+            std::memcpy(value.data(), in, value.size() * sizeof(T));
+
+        return in + count * sizeof(T);
+    }
+
+    static const char* read(vector_type& value, boost::uint64_t count,
+        const char* in, const char* end, std::false_type)
+    {
+        value.clear();
+
+        for (boost::uint64_t i = 0; i < count && in != 0; i++) {
+            value.push_back(T());
+            in = serializer<T>::read(value.back(), in, end);
+        }
+
+        return in;
+    }
+
+    static const char* read(vector_type& value, const char* in,
+        const char* end)
+    {
+        boost::uint64_t count;
+
+        in = serializer<boost::uint64_t>::read(count, in, end);
+
+        if (in == 0)
+            return 0;
+
+        return read(value, count, in, end, bulk_type());
+    }
+};
+
+namespace detail {
+
+/**
+ * True when the fields from i on are stored in declaration order, each
+ * one right after the previous.
+ */
+template <typename S>
+constexpr bool fields_in_order(unsigned int i = 0, size_t offset = 0)
+{
+    return i == S::num_fields || (S::get_field_offset(i) == offset &&
+        fields_in_order<S>(i + 1, offset + S::get_type_size(i)));
+}
+
+}
+
+/**
+ * True when the struct can be serialized with a single copy, which
+ * requires every field to be trivially copyable and the struct to have
+ * no padding, with the fields in declaration order, so its bytes are
+ * exactly the packed fields in order. Packed structs sort the fields by
+ * alignment, so they usually take the per-field path.
+ */
+template <typename S>
+struct is_bulk_serializable
+{
+    static const bool value = std::is_trivially_copyable<S>::value &&
+        S::packed_size == sizeof(S) && detail::fields_in_order<S>();
+};
+
+template <typename S>
+const bool is_bulk_serializable<S>::value;
+
+namespace detail {
+
+struct serialized_size_counter
+{
+    size_t total;
+
+    serialized_size_counter() :
+        total(0)
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V& v)
+    {
+        total += serializer<V>::size(v);
+    }
+};
+
+struct serialize_writer
+{
+    char* out;
+
+    serialize_writer(char* out) :
+        out(out)
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V& v)
+    {
+        out = serializer<V>::write(v, out);
+    }
+};
+
+struct serialize_reader
+{
+    const char* in;
+    const char* end;
+
+    serialize_reader(const char* in, const char* end) :
+        in(in),
+        end(end)
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(V& v)
+    {
+        if (in != 0)
+            in = serializer<V>::read(v, in, end);
+    }
+};
+
+template <typename S>
+size_t serialized_size(const S&, std::true_type)
+{
+    return sizeof(S);
+}
+
+template <typename S>
+size_t serialized_size(const S& obj, std::false_type)
+{
+    serialized_size_counter f;
+    obj.capply(f);
+    return f.total;
+}
+
+template <typename S>
+size_t serialize_unchecked(const S& obj, char* out, std::true_type)
+{
+    std::memcpy(out, &obj, sizeof(S));
+    return sizeof(S);
+}
+
+template <typename S>
+size_t serialize_unchecked(const S& obj, char* out, std::false_type)
+{
+    serialize_writer f(out);
+    obj.capply(f);
+    return f.out - out;
+}
+
+template <typename S>
+const char* deserialize(S& obj, const char* in, const char* end,
+    std::true_type)
+{
+    if (static_cast<size_t>(end - in) < sizeof(S))
+        return 0;
+
+    std::memcpy(&obj, in, sizeof(S));
+    return in + sizeof(S);
+}
+
+template <typename S>
+const char* deserialize(S& obj, const char* in, const char* end,
+    std::false_type)
+{
+    serialize_reader f(in, end);
+    obj.apply(f);
+    return f.in;
+}
+
+template <typename S>
+struct bulk_tag :
+    std::integral_constant<bool, is_bulk_serializable<S>::value>
+{
+};
+
+}
+
+/**
+ * Number of bytes written by serialize for the struct.
+ */
+template <typename S>
+size_t serialized_size(const S& obj)
+{
+    return detail::serialized_size(obj, detail::bulk_tag<S>());
+}
+
+template <typename S>
+error_code try_serialize(const S& obj, void* buffer, size_t size,
+    size_t& written)
+{
+    if (detail::bulk_tag<S>::value) {
+        if (size < sizeof(S))
+            return buffer_overflow_error;
+    }
+    else if (size < serialized_size(obj)) {
+        return buffer_overflow_error;
+    }
+
+    written = detail::serialize_unchecked(obj, static_cast<char*>(buffer),
+        detail::bulk_tag<S>());
+
+    return no_error;
+}
+
+template <typename S>
+size_t serialize(const S& obj, void* buffer, size_t size)
+{
+    size_t written;
+
+    if (try_serialize(obj, buffer, size, written) != no_error) {
+        F1D_THROW(buffer_overflow_exception()
+            << struct_name(S::get_struct_name())
+            << buffer_size(size));
+    }
+
+    return written;
+}
+
+template <typename S>
+error_code try_deserialize(S& obj, const void* buffer, size_t size,
+    size_t& read)
+{
+    const char* in = static_cast<const char*>(buffer);
+    const char* end = detail::deserialize(obj, in, in + size,
+        detail::bulk_tag<S>());
+
+    if (end == 0)
+        return buffer_overflow_error;
+
+    read = end - in;
+    return no_error;
+}
+
+template <typename S>
+size_t deserialize(S& obj, const void* buffer, size_t size)
+{
+    size_t read;
+
+    if (try_deserialize(obj, buffer, size, read) != no_error) {
+        F1D_THROW(buffer_overflow_exception()
+            << struct_name(S::get_struct_name())
+            << buffer_size(size));
+    }
+
+    return read;
+}
+
+}
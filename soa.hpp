@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "fields.hpp"
+#include "column.hpp"
+
+#include <boost/preprocessor/punctuation/comma_if.hpp>
+#include <boost/preprocessor/seq/seq.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_STRUCT_SOA_NAME(Name) \
+    BOOST_PP_CAT(Name, _soa)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_SOA_ASSEMBLE_COLUMN(Namespace, Name) \
+    f1d::column<F1D_STRUCT_FULL_TYPE(Namespace, Name)> Name;
+
+#define F1D_SOA_ASSEMBLE_COLUMNS(_s, Namespace, i, elem) \
+    F1D_SOA_ASSEMBLE_COLUMN( \
+        Namespace, \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem))
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_SOA_ASSEMBLE_REF(Qualifier, Namespace, Name) \
+    Qualifier F1D_STRUCT_FULL_TYPE(Namespace, Name)& Name;
+
+#define F1D_SOA_ASSEMBLE_REFS(_s, what, i, elem) \
+    F1D_SOA_ASSEMBLE_REF( \
+        BOOST_PP_TUPLE_ELEM(2, 0, what), \
+        BOOST_PP_TUPLE_ELEM(2, 1, what), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem))
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_SOA_ASSEMBLE_REF_INIT(Source, Index, Name, i) \
+    BOOST_PP_COMMA_IF(i) Name((Source).Name[Index])
+
+#define F1D_SOA_ASSEMBLE_REF_INITS(_s, what, i, elem) \
+    F1D_SOA_ASSEMBLE_REF_INIT( \
+        BOOST_PP_TUPLE_ELEM(2, 0, what), \
+        BOOST_PP_TUPLE_ELEM(2, 1, what), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem), \
+        i)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_SOA_ASSEMBLE_COPY(Target, TargetField, Source, SourceField, \
+    Name) \
+    TargetField(Target, Name) = SourceField(Source, Name);
+
+#define F1D_SOA_ASSEMBLE_COPIES(_s, what, i, elem) \
+    F1D_SOA_ASSEMBLE_COPY( \
+        BOOST_PP_TUPLE_ELEM(4, 0, what), \
+        BOOST_PP_TUPLE_ELEM(4, 1, what), \
+        BOOST_PP_TUPLE_ELEM(4, 2, what), \
+        BOOST_PP_TUPLE_ELEM(4, 3, what), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem))
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_SOA_ASSEMBLE_CALL(Method, Arg, Name) \
+    Name.Method(Arg);
+
+#define F1D_SOA_ASSEMBLE_CALLS(_s, what, i, elem) \
+    F1D_SOA_ASSEMBLE_CALL( \
+        BOOST_PP_TUPLE_ELEM(2, 0, what), \
+        BOOST_PP_TUPLE_ELEM(2, 1, what), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem))
+
+#define F1D_SOA_ASSEMBLE_PUSH(Source, Field, Name) \
+    Name.push_back(Field(Source, Name));
+
+#define F1D_SOA_ASSEMBLE_PUSHES(_s, what, i, elem) \
+    F1D_SOA_ASSEMBLE_PUSH( \
+        BOOST_PP_TUPLE_ELEM(2, 0, what), \
+        BOOST_PP_TUPLE_ELEM(2, 1, what), \
+        BOOST_PP_TUPLE_ELEM(2, 0, elem))
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_SOA_NO_SETTERS(Name, ProxyName, Fields, Field)
+
+#define F1D_SOA_ASSEMBLE_PROXY_SETTERS(Name, ProxyName, Fields, Field) \
+        inline ProxyName& operator =(const ProxyName& other) \
+        { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_COPIES, \
+                (*this, F1D_LAYOUT_PLAIN_FIELD, other, \
+                F1D_LAYOUT_PLAIN_FIELD), Fields) \
+            return *this; \
+        } \
+        inline ProxyName& operator =(const Name& obj) \
+        { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_COPIES, \
+                (*this, F1D_LAYOUT_PLAIN_FIELD, obj, Field), Fields) \
+            return *this; \
+        } \
+        template <typename Functor> \
+        void apply(Functor& f) \
+        { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+                (Name, *this, f, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+        } \
+        template <typename Functor> \
+        void apply(const Functor& f) \
+        { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+                (Name, *this, f, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+        }
+
+#define F1D_SOA_ASSEMBLE_PROXY(Name, ProxyName, Qualifier, SoAQualifier, \
+    Fields, Setters, Field) \
+    class ProxyName { \
+    public: \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_REFS, (Qualifier, types), \
+            Fields) \
+        inline ProxyName(SoAQualifier F1D_STRUCT_SOA_NAME(Name)& soa, \
+            size_t index) : \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_REF_INITS, \
+                (soa, index), Fields) \
+        { \
+        } \
+        Setters(Name, ProxyName, Fields, Field) \
+        inline operator Name() const \
+        { \
+            Name obj; \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_COPIES, \
+                (obj, Field, *this, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+            return obj; \
+        } \
+        template <typename Functor> \
+        void capply(Functor& f) const \
+        { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+                (Name, *this, f, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+        } \
+        template <typename Functor> \
+        void capply(const Functor& f) const \
+        { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+                (Name, *this, f, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+        } \
+    };
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define F1D_SOA_MAKE_S1(Name, NF, Fields, Layout) \
+class F1D_STRUCT_SOA_NAME(Name) { \
+public: \
+    typedef Name value_type; \
+    static const unsigned int num_fields = NF; \
+    BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_COLUMNS, types, Fields) \
+    F1D_SOA_ASSEMBLE_PROXY(Name, const_reference, const, const, Fields, \
+        F1D_SOA_NO_SETTERS, BOOST_PP_CAT(Layout, _FIELD)) \
+    F1D_SOA_ASSEMBLE_PROXY(Name, reference, , , Fields, \
+        F1D_SOA_ASSEMBLE_PROXY_SETTERS, BOOST_PP_CAT(Layout, _FIELD)) \
+    inline static const char* get_struct_name() \
+    { \
+        return Name::get_struct_name(); \
+    } \
+    inline size_t size() const \
+    { \
+        return BOOST_PP_TUPLE_ELEM(2, 0, BOOST_PP_SEQ_HEAD(Fields)).size(); \
+    } \
+    inline bool empty() const \
+    { \
+        return size() == 0; \
+    } \
+    inline void reserve(size_t n) \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_CALLS, (reserve, n), Fields) \
+    } \
+    inline void clear() \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_CALLS, (clear, ), Fields) \
+    } \
+    inline void push_back(const Name& obj) \
+    { \
+        const size_t n = size(); \
+        try { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_PUSHES, \
+                (obj, BOOST_PP_CAT(Layout, _FIELD)), Fields) \
+        } \
+        catch (...) { \
+            BOOST_PP_SEQ_FOR_EACH_I(F1D_SOA_ASSEMBLE_CALLS, (truncate, n), \
+                Fields) \
+            throw; \
+        } \
+    } \
+    inline reference operator [](size_t index) \
+    { \
+        return reference(*this, index); \
+    } \
+    inline const_reference operator [](size_t index) const \
+    { \
+        return const_reference(*this, index); \
+    } \
+    template <typename Functor> \
+    void apply(Functor& f) \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+            (Name, *this, f, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+    } \
+    template <typename Functor> \
+    void capply(Functor& f) const \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+            (Name, *this, f, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+    } \
+    template <typename Functor> \
+    void apply(const Functor& f) \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+            (Name, *this, f, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+    } \
+    template <typename Functor> \
+    void capply(const Functor& f) const \
+    { \
+        BOOST_PP_SEQ_FOR_EACH_I(F1D_STRUCT_ASSEMBLE_APPLYS, \
+            (Name, *this, f, F1D_LAYOUT_PLAIN_FIELD), Fields) \
+    } \
+};
+
+#define F1D_SOA_MAKE(Name, Fields) \
+    F1D_SOA_MAKE_S1(Name, BOOST_PP_SEQ_SIZE(Fields), Fields, \
+        F1D_LAYOUT_PLAIN)
+
+/**
+ * SoA container for a struct made with F1D_STRUCT_MAKE_PACKED.
+ */
+#define F1D_SOA_MAKE_PACKED(Name, Fields) \
+    F1D_SOA_MAKE_S1(Name, BOOST_PP_SEQ_SIZE(Fields), Fields, \
+        F1D_LAYOUT_PACKED)
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace f1d {
+
+/**
+ * Non-owning view over contiguous values, built from a pointer and a
+ * size, an array or a container with data() and size(), such as
+ * std::vector or f1d::column.
+ */
+template <typename T>
+class span
+{
+public:
+
+    typedef T element_type;
+    typedef typename std::remove_cv<T>::type value_type;
+    typedef T* iterator;
+
+private:
+
+    T* _data;
+    size_t _size;
+
+public:
+
+    span() :
+        _data(0),
+        _size(0)
+    {
+    }
+
+    span(T* data, size_t size) :
+        _data(data),
+        _size(size)
+    {
+    }
+
+    template <size_t N>
+    span(T (&array)[N]) :
+        _data(array),
+        _size(N)
+    {
+    }
+
+    template <typename Container, typename Enable = typename std::enable_if<
+        !std::is_same<typename std::remove_cv<Container>::type,
+            span>::value>::type>
+    span(Container& c) :
+        _data(c.data()),
+        _size(c.size())
+    {
+    }
+
+    T* data() const
+    {
+        return _data;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    iterator begin() const
+    {
+        return _data;
+    }
+
+    iterator end() const
+    {
+        return _data + _size;
+    }
+
+    T& operator [](size_t i) const
+    {
+        return _data[i];
+    }
+};
+
+}
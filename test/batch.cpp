@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <f1d/soa.hpp>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define BATCH_TEST_FIELDS \
+    ( (id,     int        ) ) \
+    ( (price,  double     ) ) \
+    ( (symbol, std::string) )
+
+namespace test_batch {
+
+F1D_STRUCT_MAKE(quote, BATCH_TEST_FIELDS)
+
+F1D_SOA_MAKE(quote, BATCH_TEST_FIELDS)
+
+namespace packed {
+
+F1D_STRUCT_MAKE_PACKED(packed_quote,
+    ( (flag,  char  ) )
+    ( (price, double) )
+    ( (count, int   ) )
+) // packed_quote
+
+}
+
+namespace fragile {
+
+/**
+ * Throws when copied from a negative value.
+ */
+struct checked_int
+{
+    int value;
+
+    checked_int(int value = 0) :
+        value(value)
+    {
+    }
+
+    checked_int(const checked_int& other) :
+        value(check(other.value))
+    {
+    }
+
+    checked_int& operator =(const checked_int& other)
+    {
+        value = check(other.value);
+        return *this;
+    }
+
+    static int check(int value)
+    {
+        if (value < 0)
+            throw std::runtime_error("negative value");
+
+        return value;
+    }
+};
+
+#define FRAGILE_TEST_FIELDS \
+    ( (key,   int        ) ) \
+    ( (count, checked_int) )
+
+F1D_STRUCT_MAKE(fragile_row, FRAGILE_TEST_FIELDS)
+
+F1D_SOA_MAKE(fragile_row, FRAGILE_TEST_FIELDS)
+
+}
+
+template <typename F, typename C, typename Enable = void>
+struct can_append :
+    std::false_type
+{
+};
+
+template <typename F, typename C>
+struct can_append<F, C,
+    decltype(void(std::declval<const F&>().append(std::declval<C&>())))> :
+    std::true_type
+{
+};
+
+}
+
+/**
+ * Test building a batch of structs into a vector
+ */
+TEST(BatchFactoryTest, Vector)
+{
+    using namespace test_batch;
+
+    const int ids[] = { 1, 2, 3, 4 };
+    const std::vector<double> prices = { 1.5, 2.5, 3.5, 4.5 };
+    const std::vector<std::string> symbols = { "A", "B", "C", "D" };
+
+    std::vector<quote> out(1);
+    quote_batch_factory f;
+
+    f.begin(4);
+    f.set_id(ids);
+    f.set_symbol(symbols);
+    f.set_price(prices);
+    f.end();
+    f.append(out);
+
+    ASSERT_EQ(out.size(), 5u);
+
+    for (size_t i = 0; i < 4; i++) {
+        EXPECT_EQ(out[i + 1].id, ids[i]);
+        EXPECT_EQ(out[i + 1].price, prices[i]);
+        EXPECT_EQ(out[i + 1].symbol, symbols[i]);
+    }
+
+    f.begin(2);
+    f.set_id(f1d::span<const int>(ids + 2, 2));
+    f.set_price(f1d::span<const double>(prices.data(), 2));
+    f.set_symbol(f1d::span<const std::string>(symbols.data(), 2));
+    f.end();
+    f.append(out);
+
+    ASSERT_EQ(out.size(), 7u);
+    EXPECT_EQ(out[5].id, 3);
+    EXPECT_EQ(out[6].symbol, "B");
+}
+
+/**
+ * Test building a batch of structs into an SoA container
+ */
+TEST(BatchFactoryTest, SoA)
+{
+    using namespace test_batch;
+
+    const std::vector<int> ids = { 7, 8, 9 };
+    const std::vector<double> prices = { 0.5, 0.25, 0.125 };
+    const std::vector<std::string> symbols = { "X", "Y", "Z" };
+
+    quote_soa out;
+    quote_batch_factory f;
+
+    f.begin(ids.size());
+    f.set_id(ids);
+    f.set_price(prices);
+    f.set_symbol(symbols);
+    f.end();
+    f.append(out);
+    f.append(out);
+
+    ASSERT_EQ(out.size(), 6u);
+    EXPECT_EQ(out.id[4], 8);
+    EXPECT_EQ(out.price[2], 0.125);
+    EXPECT_EQ(out.symbol[3], "X");
+}
+
+/**
+ * Test building packed structs
+ */
+TEST(BatchFactoryTest, Packed)
+{
+    typedef test_batch::packed::packed_quote S;
+
+    const char flags[] = { 'a', 'b' };
+    const double prices[] = { 1.25, 2.25 };
+    const int counts[] = { 10, 20 };
+
+    std::vector<S> out;
+    test_batch::packed::packed_quote_batch_factory f;
+
+    f.begin(2);
+    f.set_flag(flags);
+    f.set_price(prices);
+    f.set_count(counts);
+    f.end();
+    f.append(out);
+
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[1].flag(), 'b');
+    EXPECT_EQ(out[1].price(), 2.25);
+    EXPECT_EQ(out[0].count(), 10);
+}
+
+/**
+ * Test that append only accepts containers of the factory struct
+ */
+TEST(BatchFactoryTest, Container)
+{
+    using namespace test_batch;
+
+    EXPECT_TRUE((can_append<quote_batch_factory,
+        std::vector<quote> >::value));
+    EXPECT_TRUE((can_append<quote_batch_factory, quote_soa>::value));
+    EXPECT_FALSE((can_append<quote_batch_factory,
+        std::vector<fragile::fragile_row> >::value));
+    EXPECT_FALSE((can_append<quote_batch_factory,
+        fragile::fragile_row_soa>::value));
+    EXPECT_FALSE((can_append<fragile::fragile_row_batch_factory,
+        quote_soa>::value));
+}
+
+/**
+ * Test the validation of the batch factory
+ */
+TEST(BatchFactoryTest, Errors)
+{
+    using namespace test_batch;
+
+    const std::vector<int> ids = { 1, 2 };
+    const std::vector<double> prices = { 1.0, 2.0, 3.0 };
+    const std::vector<std::string> symbols = { "A", "B" };
+
+    std::vector<quote> out;
+    quote_batch_factory f;
+
+    EXPECT_EQ(f.try_set_id(ids), f1d::not_initialized_error);
+    EXPECT_EQ(f.try_end(), f1d::not_initialized_error);
+    EXPECT_THROW(f.append(out), f1d::not_intialized_exception);
+    EXPECT_EQ(f.try_begin(2), f1d::no_error);
+    EXPECT_EQ(f.try_begin(2), f1d::not_finished_error);
+    EXPECT_EQ(f.try_set_id(ids), f1d::no_error);
+    EXPECT_EQ(f.try_set_id(ids), f1d::already_set_error);
+    EXPECT_EQ(f.try_set_price(prices), f1d::size_mismatch_error);
+    EXPECT_THROW(f.set_price(prices), f1d::size_mismatch_exception);
+    EXPECT_EQ(f.try_end(), f1d::not_set_error);
+    EXPECT_THROW(f.end(), f1d::not_set_exception);
+    EXPECT_THROW(f.append(out), f1d::not_finished_exception);
+    EXPECT_EQ(f.try_set_price(f1d::span<const double>(prices.data(), 2)),
+        f1d::no_error);
+    EXPECT_EQ(f.try_set_symbol(symbols), f1d::no_error);
+    EXPECT_EQ(f.try_end(), f1d::no_error);
+    EXPECT_EQ(f.try_end(), f1d::already_finished_error);
+    EXPECT_EQ(f.try_set_symbol(symbols), f1d::already_finished_error);
+    EXPECT_NO_THROW(f.append(out));
+    EXPECT_EQ(out.size(), 2u);
+
+    try {
+        f.begin(2);
+        f.set_id(ids);
+        f.end();
+        FAIL() << "end() did not throw";
+    }
+    catch (const f1d::not_set_exception& ex) {
+        const f1d::pretty_string_vector* names =
+            boost::get_error_info<f1d::field_names>(ex);
+
+        ASSERT_TRUE(names != 0);
+        ASSERT_EQ(names->values.size(), 2u);
+        EXPECT_EQ(names->values[0], "price");
+    }
+}
+
+/**
+ * Test the unchecked batch factory
+ */
+TEST(BatchFactoryTest, Unchecked)
+{
+    using namespace test_batch;
+
+    const std::vector<int> ids = { 1, 2 };
+    const std::vector<double> prices = { 1.0, 2.0 };
+    const std::vector<std::string> symbols = { "A", "B" };
+
+    std::vector<quote> out;
+    quote_basic_batch_factory<f1d::unchecked_factory> f;
+
+    ASSERT_NO_THROW(f.begin(2));
+    ASSERT_NO_THROW(f.begin(2));
+    ASSERT_NO_THROW(f.set_id(ids));
+    ASSERT_NO_THROW(f.set_price(prices));
+    ASSERT_NO_THROW(f.set_symbol(symbols));
+    ASSERT_NO_THROW(f.append(out));
+
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[1].symbol, "B");
+}
+
+/**
+ * Test that a failed append leaves the containers unchanged
+ */
+TEST(BatchFactoryTest, Rollback)
+{
+    using namespace test_batch::fragile;
+
+    const int keys[] = { 1, 2, 3 };
+    const checked_int counts[] = { 10, -1, 30 };
+
+    std::vector<fragile_row> rows(1);
+    fragile_row_soa columns;
+    columns.push_back(rows[0]);
+
+    fragile_row_batch_factory f;
+
+    f.begin(3);
+    f.set_key(keys);
+    f.set_count(counts);
+    f.end();
+
+    EXPECT_THROW(f.append(rows), std::runtime_error);
+    EXPECT_THROW(f.append(columns), std::runtime_error);
+
+    EXPECT_EQ(rows.size(), 1u);
+    EXPECT_EQ(columns.size(), 1u);
+    EXPECT_EQ(columns.key.size(), 1u);
+    EXPECT_EQ(columns.count.size(), 1u);
+}
+
+/**
+ * Test that appending small batches grows the columns geometrically
+ */
+TEST(BatchFactoryTest, Growth)
+{
+    using namespace test_batch;
+
+    const int ids[] = { 1 };
+    const double prices[] = { 1.0 };
+    const std::string symbols[] = { "A" };
+
+    quote_soa out;
+    quote_batch_factory f;
+
+    f.begin(1);
+    f.set_id(ids);
+    f.set_price(prices);
+    f.set_symbol(symbols);
+    f.end();
+
+    for (size_t i = 0; i < 5; i++)
+        f.append(out);
+
+    ASSERT_EQ(out.size(), 5u);
+    EXPECT_EQ(out.id.capacity(), 8u);
+    EXPECT_EQ(out.symbol.capacity(), 8u);
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/fields.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace test_compare {
+
+F1D_STRUCT_MAKE(row,
+    ( (a, int        ) )
+    ( (b, int        ) )
+    ( (c, char       ) )
+    ( (d, double     ) )
+    ( (e, std::string) )
+) // row
+
+namespace packed {
+
+F1D_STRUCT_MAKE_PACKED(packed_row,
+    ( (flag, char ) )
+    ( (id,   long ) )
+    ( (kind, short) )
+) // packed_row
+
+}
+
+/**
+ * Counts the comparisons made on a field, to check short-circuiting.
+ */
+struct counted
+{
+    static int comparisons;
+
+    int value;
+
+    counted(int value = 0) :
+        value(value)
+    {
+    }
+};
+
+int counted::comparisons = 0;
+
+inline bool operator ==(const counted& a, const counted& b)
+{
+    counted::comparisons++;
+    return a.value == b.value;
+}
+
+inline bool operator <(const counted& a, const counted& b)
+{
+    counted::comparisons++;
+    return a.value < b.value;
+}
+
+/**
+ * Equality ignoring the case of a letter, so equal values can have
+ * different bytes.
+ */
+struct letter
+{
+    char value;
+};
+
+inline bool operator ==(const letter& a, const letter& b)
+{
+    return (a.value | 0x20) == (b.value | 0x20);
+}
+
+namespace user_equality {
+
+F1D_STRUCT_MAKE(tagged,
+    ( (id,     int   ) )
+    ( (letter, letter) )
+) // tagged
+
+}
+
+namespace short_circuit {
+
+F1D_STRUCT_MAKE(lazy,
+    ( (key,  int    ) )
+    ( (tail, counted) )
+) // lazy
+
+}
+
+void fill(row& r)
+{
+    r.a = 1;
+    r.b = 2;
+    r.c = 'x';
+    r.d = 0.5;
+    r.e = "key";
+}
+
+}
+
+/**
+ * Test equality of every field and that padding is ignored
+ */
+TEST(CompareTest, Equality)
+{
+    using namespace test_compare;
+
+    alignas(row) char storage1[sizeof(row)];
+    alignas(row) char storage2[sizeof(row)];
+
+    std::memset(storage1, 0xAA, sizeof(row));
+    std::memset(storage2, 0x55, sizeof(row));
+
+    row* r1 = new (storage1) row;
+    row* r2 = new (storage2) row;
+
+    fill(*r1);
+    fill(*r2);
+
+    EXPECT_TRUE(*r1 == *r2);
+    EXPECT_FALSE(*r1 != *r2);
+
+    r1->d = 0.0;
+    r2->d = -0.0;
+
+    EXPECT_TRUE(*r1 == *r2);
+
+    row m = *r1;
+    m.a = 10;
+    EXPECT_TRUE(m != *r1);
+
+    m = *r1;
+    m.c = 'y';
+    EXPECT_TRUE(m != *r1);
+
+    m = *r1;
+    m.d = 1.5;
+    EXPECT_TRUE(m != *r1);
+
+    m = *r1;
+    m.e = "other";
+    EXPECT_TRUE(m != *r1);
+
+    r1->~row();
+    r2->~row();
+}
+
+/**
+ * Test the lexicographic order in field declaration order
+ */
+TEST(CompareTest, Less)
+{
+    using namespace test_compare;
+
+    row r1;
+    row r2;
+
+    fill(r1);
+    fill(r2);
+
+    EXPECT_FALSE(r1 < r2);
+    EXPECT_FALSE(r2 < r1);
+
+    r2.e = "kez";
+    EXPECT_TRUE(r1 < r2);
+    EXPECT_FALSE(r2 < r1);
+
+    r1.b = 3;
+    EXPECT_FALSE(r1 < r2);
+    EXPECT_TRUE(r2 < r1);
+
+    r2.a = 0;
+    EXPECT_TRUE(r2 < r1);
+}
+
+/**
+ * Test that the comparisons stop at the first field that decides them
+ */
+TEST(CompareTest, ShortCircuit)
+{
+    using namespace test_compare;
+    using short_circuit::lazy;
+
+    lazy l1;
+    lazy l2;
+
+    l1.key = 1;
+    l2.key = 2;
+
+    counted::comparisons = 0;
+
+    EXPECT_TRUE(l1 != l2);
+    EXPECT_TRUE(l1 < l2);
+    EXPECT_FALSE(l2 < l1);
+    EXPECT_EQ(counted::comparisons, 0);
+
+    l2.key = 1;
+    l2.tail = 5;
+
+    EXPECT_TRUE(l1 != l2);
+    EXPECT_TRUE(l1 < l2);
+    EXPECT_GT(counted::comparisons, 0);
+}
+
+/**
+ * Test that fields with their own operator == are not compared bitwise
+ */
+TEST(CompareTest, UserEquality)
+{
+    using namespace test_compare;
+    using user_equality::tagged;
+
+    EXPECT_FALSE(f1d::is_bitwise_hashable<letter>::value);
+
+    tagged t1;
+    tagged t2;
+
+    t1.id = 1;
+    t1.letter.value = 'a';
+    t2.id = 1;
+    t2.letter.value = 'A';
+
+    EXPECT_TRUE(t1 == t2);
+}
+
+/**
+ * Test sorting by a subset of the fields
+ */
+TEST(CompareTest, CompareBy)
+{
+    using namespace test_compare;
+
+    std::vector<row> rows(6);
+
+    for (int i = 0; i < 6; i++) {
+        fill(rows[i]);
+        rows[i].a = i % 2;
+        rows[i].b = 10 - i;
+        rows[i].c = 'a' + i / 3;
+    }
+
+    std::sort(rows.begin(), rows.end(),
+        f1d::compare_by<types::c_f, types::b_f>());
+
+    for (int i = 1; i < 6; i++) {
+        EXPECT_LE(rows[i - 1].c, rows[i].c);
+        if (rows[i - 1].c == rows[i].c) {
+            EXPECT_LT(rows[i - 1].b, rows[i].b);
+        }
+    }
+
+    f1d::compare_by<types::a_f> by_a;
+
+    EXPECT_FALSE(by_a(rows[0], rows[0]));
+    EXPECT_TRUE(f1d::compare_by<>()(rows[0], rows[1]) == false);
+
+    std::stable_sort(rows.begin(), rows.end(), by_a);
+
+    EXPECT_EQ(rows[0].a, 0);
+    EXPECT_EQ(rows[5].a, 1);
+}
+
+/**
+ * Test comparing packed structs
+ */
+TEST(CompareTest, Packed)
+{
+    typedef test_compare::packed::packed_row S;
+
+    S s1;
+    S s2;
+
+    s1.flag() = s2.flag() = 'f';
+    s1.id() = s2.id() = 123456789;
+    s1.kind() = s2.kind() = 7;
+
+    EXPECT_TRUE(s1 == s2);
+    EXPECT_FALSE(s1 < s2);
+
+    s2.kind() = 8;
+
+    EXPECT_TRUE(s1 != s2);
+    EXPECT_TRUE(s1 < s2);
+    EXPECT_TRUE(f1d::compare_by<test_compare::packed::types::kind_f>()(
+        s1, s2));
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/fields.hpp>
+#include <f1d/descriptor.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace test_descriptor {
+
+struct point
+{
+    int x;
+    int y;
+};
+
+F1D_STRUCT_MAKE(record,
+    ( (id,     int        ) )
+    ( (price,  double     ) )
+    ( (symbol, std::string) )
+    ( (side,   char       ) )
+    ( (origin, point      ) )
+) // record
+
+namespace packed {
+
+F1D_STRUCT_MAKE_PACKED(packed_record,
+    ( (flag,  char  ) )
+    ( (value, double) )
+) // packed_record
+
+}
+
+/**
+ * Comparator using only the type-erased descriptor of a field.
+ */
+struct descriptor_less
+{
+    const f1d::field_descriptor* field;
+
+    bool operator ()(const record& a, const record& b) const
+    {
+        return field->compare(field->field(&a), field->field(&b)) < 0;
+    }
+};
+
+}
+
+/**
+ * Test the static description of the fields
+ */
+TEST(DescriptorTest, Fields)
+{
+    using namespace test_descriptor;
+
+    const f1d::field_descriptor* fields =
+        f1d::get_field_descriptors<record>();
+
+    EXPECT_EQ(fields, f1d::get_field_descriptors<record>());
+
+    for (unsigned int i = 0; i < record::num_fields; i++) {
+        EXPECT_EQ(fields[i].index, i);
+        EXPECT_STREQ(fields[i].name, record::get_field_name(i));
+        EXPECT_STREQ(fields[i].type_name, record::get_type_name(i));
+        EXPECT_EQ(fields[i].offset, record::get_field_offset(i));
+        EXPECT_EQ(fields[i].size, record::get_type_size(i));
+        EXPECT_EQ(fields[i].alignment, record::get_field_alignment(i));
+    }
+
+    EXPECT_EQ(fields[0].tag, f1d::int32_tag);
+    EXPECT_EQ(fields[1].tag, f1d::double_tag);
+    EXPECT_EQ(fields[2].tag, f1d::string_tag);
+    EXPECT_EQ(fields[3].tag, f1d::char_tag);
+    EXPECT_EQ(fields[4].tag, f1d::other_tag);
+
+    for (unsigned int i = 0; i < 4; i++) {
+        EXPECT_TRUE(fields[i].compare != 0);
+        EXPECT_TRUE(fields[i].hash != 0);
+        EXPECT_TRUE(fields[i].to_string != 0);
+        EXPECT_TRUE(fields[i].from_string != 0);
+    }
+
+    EXPECT_TRUE(fields[4].compare == 0);
+    EXPECT_TRUE(fields[4].hash == 0);
+    EXPECT_TRUE(fields[4].to_string == 0);
+    EXPECT_TRUE(fields[4].from_string == 0);
+}
+
+/**
+ * Test the field operations through the descriptors
+ */
+TEST(DescriptorTest, Operations)
+{
+    using namespace test_descriptor;
+
+    const f1d::field_descriptor* fields =
+        f1d::get_field_descriptors<record>();
+
+    record a;
+    record b;
+
+    a.id = 3;
+    a.price = 0.1;
+    a.symbol = "ABC";
+    a.side = 'B';
+
+    b = a;
+    b.id = 5;
+
+    const f1d::field_descriptor& id = fields[0];
+
+    EXPECT_EQ(id.compare(id.field(&a), id.field(&b)), -1);
+    EXPECT_EQ(id.compare(id.field(&b), id.field(&a)), 1);
+    EXPECT_EQ(id.compare(id.field(&a), id.field(&a)), 0);
+    EXPECT_EQ(id.hash(id.field(&a)), std::hash<int>()(3));
+    EXPECT_EQ(id.to_string(id.field(&b)), "5");
+
+    EXPECT_TRUE(id.from_string(id.field(&a), "42", 2));
+    EXPECT_EQ(a.id, 42);
+    EXPECT_FALSE(id.from_string(id.field(&a), "4x", 2));
+    EXPECT_FALSE(id.from_string(id.field(&a), "", 0));
+    EXPECT_EQ(a.id, 42);
+
+    const f1d::field_descriptor& price = fields[1];
+    const std::string text = price.to_string(price.field(&a));
+    b.price = 0;
+
+    EXPECT_TRUE(price.from_string(price.field(&b), text.data(),
+        text.size()));
+    EXPECT_EQ(b.price, 0.1);
+
+    const f1d::field_descriptor& symbol = fields[2];
+
+    EXPECT_TRUE(symbol.from_string(symbol.field(&b), "X Y", 3));
+    EXPECT_EQ(b.symbol, "X Y");
+    EXPECT_EQ(symbol.to_string(symbol.field(&b)), "X Y");
+}
+
+/**
+ * Test a generic sort and lookup driven by the struct descriptor
+ */
+TEST(DescriptorTest, Struct)
+{
+    using namespace test_descriptor;
+
+    const f1d::struct_descriptor& desc =
+        f1d::get_struct_descriptor<record>();
+
+    EXPECT_STREQ(desc.name, "record");
+    EXPECT_EQ(desc.size, sizeof(record));
+    EXPECT_EQ(desc.num_fields, 5u);
+    EXPECT_TRUE(desc.find_field("nope") == 0);
+
+    const f1d::field_descriptor* field = desc.find_field("symbol");
+
+    ASSERT_TRUE(field != 0);
+    EXPECT_EQ(field->index, 2u);
+
+    std::vector<record> records(3);
+
+    records[0].symbol = "c";
+    records[1].symbol = "a";
+    records[2].symbol = "b";
+
+    descriptor_less less = { field };
+    std::sort(records.begin(), records.end(), less);
+
+    EXPECT_EQ(records[0].symbol, "a");
+    EXPECT_EQ(records[1].symbol, "b");
+    EXPECT_EQ(records[2].symbol, "c");
+}
+
+/**
+ * Test that descriptors use the physical offsets of packed structs
+ */
+TEST(DescriptorTest, Packed)
+{
+    typedef test_descriptor::packed::packed_record S;
+
+    const f1d::field_descriptor* fields = f1d::get_field_descriptors<S>();
+
+    S s;
+    s.flag() = 'f';
+    s.value() = 2.5;
+
+    EXPECT_EQ(fields[0].field(&s), &s.flag());
+    EXPECT_EQ(fields[1].field(&s), &s.value());
+    EXPECT_EQ(fields[0].to_string(fields[0].field(&s)), "f");
+    EXPECT_EQ(fields[1].to_string(fields[1].field(&s)), "2.5");
+}
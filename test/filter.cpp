@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <f1d/filter.hpp>
+#include <f1d/reduce.hpp>
+#include <f1d/soa.hpp>
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define FILTER_TEST_FIELDS \
+    ( (id,     int        ) ) \
+    ( (price,  double     ) ) \
+    ( (side,   char       ) ) \
+    ( (symbol, std::string) )
+
+namespace test_filter {
+
+F1D_STRUCT_MAKE(trade, FILTER_TEST_FIELDS)
+
+F1D_SOA_MAKE(trade, FILTER_TEST_FIELDS)
+
+std::vector<trade> make_trades(int n)
+{
+    std::vector<trade> trades(n);
+
+    for (int i = 0; i < n; i++) {
+        trades[i].id = i;
+        trades[i].price = i * 0.5;
+        trades[i].side = i % 3 ? 'B' : 'S';
+        trades[i].symbol = "S" + std::to_string(i % 10);
+    }
+
+    return trades;
+}
+
+}
+
+/**
+ * Test the predicates
+ */
+TEST(FilterTest, Predicates)
+{
+    EXPECT_TRUE(f1d::eq(3)(3));
+    EXPECT_FALSE(f1d::ne(3)(3));
+    EXPECT_TRUE(f1d::lt(3)(2.5));
+    EXPECT_TRUE(f1d::le(3)(3));
+    EXPECT_FALSE(f1d::gt(3)(3));
+    EXPECT_TRUE(f1d::ge(3)(3.5));
+    EXPECT_TRUE(f1d::between(1, 3)(1));
+    EXPECT_TRUE(f1d::between(1, 3)(3));
+    EXPECT_FALSE(f1d::between(1, 3)(3.5));
+
+    std::vector<int> many;
+
+    for (int i = 0; i < 100; i += 3)
+        many.push_back(i);
+
+    EXPECT_TRUE(f1d::in({ 4, 2, 9 })(9));
+    EXPECT_FALSE(f1d::in({ 4, 2, 9 })(3));
+    EXPECT_TRUE(f1d::in(many)(99));
+    EXPECT_FALSE(f1d::in(many)(98));
+}
+
+/**
+ * Test selecting and refining rows of a vector
+ */
+TEST(FilterTest, SelectVector)
+{
+    using namespace test_filter;
+
+    const std::vector<trade> trades = make_trades(200);
+
+    f1d::selection rows;
+
+    f1d::select<types::price_f>(trades, f1d::between(10.0, 20.0), rows);
+
+    ASSERT_EQ(rows.size(), 21u);
+    EXPECT_EQ(rows.front(), 20u);
+    EXPECT_EQ(rows.back(), 40u);
+
+    f1d::refine<types::side_f>(trades, f1d::eq('S'), rows);
+
+    ASSERT_EQ(rows.size(), 7u);
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        EXPECT_EQ(trades[rows[i]].side, 'S');
+        EXPECT_GE(trades[rows[i]].price, 10.0);
+    }
+
+    f1d::select<types::symbol_f>(trades,
+        f1d::in<std::string>({ "S1", "S7" }), rows);
+
+    EXPECT_EQ(rows.size(), 40u);
+
+    f1d::select<types::id_f>(trades, f1d::lt(0), rows);
+
+    EXPECT_TRUE(rows.empty());
+}
+
+/**
+ * Test selecting into bitmaps and combining them
+ */
+TEST(FilterTest, Bitmap)
+{
+    using namespace test_filter;
+
+    const std::vector<trade> trades = make_trades(150);
+
+    f1d::selection_bitmap low;
+    f1d::selection_bitmap sells;
+
+    f1d::select<types::id_f>(trades, f1d::lt(70), low);
+    f1d::select<types::side_f>(trades, f1d::eq('S'), sells);
+
+    EXPECT_EQ(low.size(), trades.size());
+    EXPECT_EQ(low.count(), 70u);
+    EXPECT_EQ(sells.count(), 50u);
+    EXPECT_TRUE(low.test(69));
+    EXPECT_FALSE(low.test(70));
+
+    f1d::selection rows;
+    (low & sells).to_selection(rows);
+
+    f1d::selection expected;
+    f1d::select<types::id_f>(trades, f1d::lt(70), expected);
+    f1d::refine<types::side_f>(trades, f1d::eq('S'), expected);
+
+    EXPECT_EQ(rows, expected);
+
+    f1d::refine<types::id_f>(trades, f1d::ge(30), low);
+    EXPECT_EQ(low.count(), 40u);
+    EXPECT_EQ((low | sells).count(), 40u + 50u - 14u);
+}
+
+/**
+ * Test consuming a selection of an SoA container without copying rows
+ */
+TEST(FilterTest, ConsumeSoA)
+{
+    using namespace test_filter;
+
+    const std::vector<trade> trades = make_trades(100);
+
+    trade_soa soa;
+
+    for (size_t i = 0; i < trades.size(); i++)
+        soa.push_back(trades[i]);
+
+    f1d::selection rows;
+    f1d::select<types::side_f>(soa, f1d::eq('S'), rows);
+
+    ASSERT_EQ(rows.size(), 34u);
+
+    EXPECT_DOUBLE_EQ(f1d::sum<types::price_f>(soa, rows), 841.5);
+    EXPECT_EQ(f1d::min<types::id_f>(soa, rows), 0);
+    EXPECT_EQ(f1d::max<types::id_f>(soa, rows), 99);
+    EXPECT_DOUBLE_EQ(f1d::mean<types::id_f>(soa, rows), 49.5);
+    EXPECT_EQ(f1d::count_if<types::id_f>(soa, rows, f1d::gt(50)), 17u);
+
+    std::vector<std::string> symbols;
+    f1d::project<types::symbol_f>(soa, rows, symbols);
+
+    ASSERT_EQ(symbols.size(), rows.size());
+    EXPECT_EQ(symbols[1], "S3");
+
+    rows.clear();
+    EXPECT_THROW(f1d::max<types::id_f>(soa, rows), f1d::not_found_exception);
+}
+
+/**
+ * Test iterating over the selected structs of a vector
+ */
+TEST(FilterTest, Selected)
+{
+    using namespace test_filter;
+
+    const std::vector<trade> trades = make_trades(50);
+
+    f1d::selection rows;
+    f1d::select<types::symbol_f>(trades, f1d::eq(std::string("S4")), rows);
+
+    ASSERT_EQ(std::distance(f1d::selected(trades, rows).begin(),
+        f1d::selected(trades, rows).end()), 5);
+
+    int expected = 4;
+
+    for (const trade& t : f1d::selected(trades, rows)) {
+        EXPECT_EQ(t.id, expected);
+        expected += 10;
+    }
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/fields.hpp>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <new>
+#include <string>
+#include <unordered_set>
+
+namespace test_hash {
+
+F1D_STRUCT_MAKE(keyed,
+    ( (a, int        ) )
+    ( (b, int        ) )
+    ( (c, char       ) )
+    ( (d, double     ) )
+    ( (e, std::string) )
+) // keyed
+
+namespace packed {
+
+F1D_STRUCT_MAKE_PACKED(packed_keyed,
+    ( (flag, char ) )
+    ( (id,   long ) )
+    ( (kind, short) )
+) // packed_keyed
+
+}
+
+/**
+ * Construct a struct over memory filled with the given byte, so the
+ * padding holds garbage.
+ */
+template <typename S>
+S* make_dirty(void* storage, int byte)
+{
+    std::memset(storage, byte, sizeof(S));
+    return new (storage) S;
+}
+
+void fill(keyed& k)
+{
+    k.a = 1;
+    k.b = 2;
+    k.c = 'x';
+    k.d = 0.5;
+    k.e = "key";
+}
+
+}
+
+F1D_STRUCT_STD_HASH(test_hash::keyed)
+
+/**
+ * Test that equal structs hash equally regardless of padding
+ */
+TEST(HashTest, PaddingSafe)
+{
+    using namespace test_hash;
+
+    alignas(keyed) char storage1[sizeof(keyed)];
+    alignas(keyed) char storage2[sizeof(keyed)];
+
+    keyed* k1 = make_dirty<keyed>(storage1, 0xAA);
+    keyed* k2 = make_dirty<keyed>(storage2, 0x55);
+
+    fill(*k1);
+    fill(*k2);
+
+    EXPECT_EQ(f1d::hash_struct(*k1), f1d::hash_struct(*k2));
+
+    k2->d = -0.0;
+    k1->d = 0.0;
+
+    EXPECT_EQ(f1d::hash_struct(*k1), f1d::hash_struct(*k2));
+
+    k2->c = 'y';
+
+    EXPECT_NE(f1d::hash_struct(*k1), f1d::hash_struct(*k2));
+
+    k1->~keyed();
+    k2->~keyed();
+}
+
+/**
+ * Test that every field contributes to the hash
+ */
+TEST(HashTest, AllFields)
+{
+    using namespace test_hash;
+
+    keyed k;
+    fill(k);
+
+    const size_t h = f1d::hash_struct(k);
+
+    keyed m = k;
+    m.a = 10;
+    EXPECT_NE(f1d::hash_struct(m), h);
+
+    m = k;
+    m.b = 20;
+    EXPECT_NE(f1d::hash_struct(m), h);
+
+    m = k;
+    m.d = 1.5;
+    EXPECT_NE(f1d::hash_struct(m), h);
+
+    m = k;
+    m.e = "other";
+    EXPECT_NE(f1d::hash_struct(m), h);
+}
+
+/**
+ * Test the std::hash, boost::hash and function object adapters
+ */
+TEST(HashTest, Adapters)
+{
+    using namespace test_hash;
+
+    keyed k;
+    fill(k);
+
+    const size_t h = f1d::hash_struct(k);
+
+    EXPECT_EQ(std::hash<keyed>()(k), h);
+    EXPECT_EQ(boost::hash<keyed>()(k), h);
+    EXPECT_EQ(f1d::struct_hash<keyed>()(k), h);
+
+    std::unordered_set<size_t> hashes;
+    keyed m = k;
+
+    for (int i = 0; i < 100; i++) {
+        m.a = i;
+        hashes.insert(std::hash<keyed>()(m));
+    }
+
+    EXPECT_EQ(hashes.size(), 100u);
+}
+
+/**
+ * Test hashing a subset of the fields
+ */
+TEST(HashTest, HashFields)
+{
+    using namespace test_hash;
+
+    typedef f1d::hash_fields<types::a_f, types::e_f> hasher;
+
+    keyed k1;
+    keyed k2;
+
+    fill(k1);
+    fill(k2);
+
+    k2.b = 99;
+    k2.d = 99;
+
+    EXPECT_EQ(hasher()(k1), hasher()(k2));
+    EXPECT_NE(f1d::hash_struct(k1), f1d::hash_struct(k2));
+
+    k2.e = "changed";
+
+    EXPECT_NE(hasher()(k1), hasher()(k2));
+    EXPECT_NE(f1d::hash_fields<types::e_f>()(k1),
+        f1d::hash_fields<types::a_f>()(k1));
+}
+
+/**
+ * Test hashing packed structs
+ */
+TEST(HashTest, Packed)
+{
+    typedef test_hash::packed::packed_keyed S;
+
+    S s1;
+    S s2;
+
+    s1.flag() = s2.flag() = 'f';
+    s1.id() = s2.id() = 123456789;
+    s1.kind() = s2.kind() = 7;
+
+    EXPECT_EQ(f1d::hash_struct(s1), f1d::hash_struct(s2));
+
+    s2.kind() = 8;
+
+    EXPECT_NE(f1d::hash_struct(s1), f1d::hash_struct(s2));
+}
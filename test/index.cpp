@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <f1d/index.hpp>
+#include <f1d/soa.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#define INDEX_TEST_FIELDS \
+    ( (order_id, long       ) ) \
+    ( (symbol,   std::string) ) \
+    ( (price,    double     ) )
+
+namespace test_index {
+
+F1D_STRUCT_MAKE(order, INDEX_TEST_FIELDS)
+
+F1D_SOA_MAKE(order, INDEX_TEST_FIELDS)
+
+order make_order(long id)
+{
+    order o;
+    o.order_id = id;
+    o.symbol = "S" + std::to_string(id % 7);
+    o.price = id * 0.5;
+    return o;
+}
+
+}
+
+/**
+ * Test building an index over a vector and looking up rows
+ */
+TEST(IndexTest, Find)
+{
+    using namespace test_index;
+
+    std::vector<order> orders;
+
+    for (long i = 0; i < 1000; i++)
+        orders.push_back(make_order(i * 16));
+
+    f1d::index<order, types::order_id_f> idx(orders);
+
+    EXPECT_EQ(idx.size(), orders.size());
+    EXPECT_GE(idx.capacity() * 3, idx.size() * 4);
+
+    for (size_t i = 0; i < orders.size(); i++)
+        EXPECT_EQ(idx.find(orders[i].order_id), i);
+
+    EXPECT_EQ(idx.find(1), idx.npos);
+    EXPECT_FALSE(idx.contains(-16));
+    EXPECT_TRUE(idx.contains(32));
+}
+
+/**
+ * Test incremental inserts, duplicate keys and erasing rows
+ */
+TEST(IndexTest, InsertErase)
+{
+    using namespace test_index;
+
+    std::vector<order> orders;
+    f1d::index<order, types::order_id_f> idx(orders);
+
+    EXPECT_TRUE(idx.empty());
+    EXPECT_EQ(idx.find(0), idx.npos);
+
+    for (long i = 0; i < 500; i++) {
+        orders.push_back(make_order(i));
+        EXPECT_TRUE(idx.insert(orders.size() - 1));
+    }
+
+    orders.push_back(make_order(42));
+    EXPECT_FALSE(idx.insert(orders.size() - 1));
+    EXPECT_FALSE(idx.erase(orders.size() - 1));
+    EXPECT_EQ(idx.find(42), 42u);
+    orders.pop_back();
+
+    for (long i = 0; i < 500; i += 2)
+        EXPECT_TRUE(idx.erase(i));
+
+    EXPECT_FALSE(idx.erase(0));
+    EXPECT_EQ(idx.size(), 250u);
+
+    for (long i = 0; i < 500; i++)
+        EXPECT_EQ(idx.find(i), i % 2 ? static_cast<size_t>(i) : idx.npos);
+
+    orders[10].order_id = 10000;
+    EXPECT_TRUE(idx.insert(10));
+    EXPECT_EQ(idx.find(10000), 10u);
+}
+
+/**
+ * Test indexing an SoA container by a string field
+ */
+TEST(IndexTest, SoA)
+{
+    using namespace test_index;
+
+    order_soa orders;
+
+    for (long i = 0; i < 7; i++)
+        orders.push_back(make_order(i));
+
+    f1d::index<order, types::symbol_f, order_soa> idx(orders);
+
+    EXPECT_EQ(idx.size(), 7u);
+    EXPECT_EQ(idx.find("S3"), 3u);
+
+    orders.push_back(make_order(7));
+    EXPECT_FALSE(idx.insert(7));
+
+    EXPECT_TRUE(idx.erase(0));
+    EXPECT_TRUE(idx.insert(7));
+    EXPECT_EQ(idx.find("S0"), 7u);
+
+    idx.clear();
+    EXPECT_TRUE(idx.empty());
+    EXPECT_EQ(idx.find("S3"), idx.npos);
+
+    idx.rebuild();
+    EXPECT_EQ(idx.find("S0"), 0u);
+
+    // Grow the columns past their capacity between lookups, the symbols
+    // repeat so every insert compares against the reallocated column
+    for (long i = 8; i < 200; i++) {
+        orders.push_back(make_order(i));
+        EXPECT_FALSE(idx.insert(orders.size() - 1));
+        EXPECT_EQ(idx.find("S1"), 1u);
+    }
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define F1D_INSTRUMENT
+
+#include <f1d/fields.hpp>
+#include <f1d/instrument.hpp>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace test_instrument {
+
+F1D_TRAITS_MAKE()
+
+F1D_STRUCT_MAKE_NT(hot_cold,
+    ( (hot,  int   ) )
+    ( (warm, double) )
+    ( (cold, char  ) )
+) // hot_cold
+
+struct noop
+{
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V&) const
+    {
+    }
+};
+
+}
+
+namespace test_instrument_packed {
+
+F1D_TRAITS_MAKE()
+
+F1D_STRUCT_MAKE_PACKED_NT(packed_hot_cold,
+    ( (hot,  char  ) )
+    ( (cold, double) )
+) // packed_hot_cold
+
+struct noop
+{
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V&) const
+    {
+    }
+};
+
+}
+
+/**
+ * Test the counts of the factory setters and getters
+ */
+TEST(InstrumentTest, FactoryCounts)
+{
+    using namespace test_instrument;
+
+    f1d::reset_field_access_counts<hot_cold>();
+
+    hot_cold_factory f;
+    f.begin();
+    f.set_hot(1);
+    f.emplace_warm(2.0);
+    f.set_cold('c');
+    f.end();
+
+    EXPECT_EQ(f.get_hot(), 1);
+    EXPECT_EQ(f.get_hot(), 1);
+
+    const std::vector<boost::uint64_t> counts =
+        f1d::get_field_access_counts<hot_cold>();
+
+    ASSERT_EQ(counts.size(), 3u);
+    EXPECT_EQ(counts[0], 3u);
+    EXPECT_EQ(counts[1], 1u);
+    EXPECT_EQ(counts[2], 1u);
+
+    // Rejected sets are not accesses
+    EXPECT_EQ(f.try_set_cold('d'), f1d::already_finished_error);
+    EXPECT_EQ(f1d::get_field_access_counts<hot_cold>()[2], 1u);
+}
+
+/**
+ * Test the counts of the field wrappers and of visit_field
+ */
+TEST(InstrumentTest, WrapperAndVisitCounts)
+{
+    using namespace test_instrument;
+
+    f1d::reset_field_access_counts<hot_cold>();
+
+    hot_cold obj;
+    obj.hot = 1;
+    obj.warm = 2.0;
+    obj.cold = 'c';
+
+    types::hot_f hot(obj);
+    hot = obj;
+    hot(obj);
+    (types::cold_f(obj))(obj);
+
+    obj.cvisit_field(0, noop());
+    obj.visit_field(1, noop());
+    EXPECT_EQ(obj.try_cvisit_field(3, noop()), f1d::not_found_error);
+
+    const std::vector<boost::uint64_t> counts =
+        f1d::get_field_access_counts<hot_cold>();
+
+    EXPECT_EQ(counts[0], 4u);
+    EXPECT_EQ(counts[1], 1u);
+    EXPECT_EQ(counts[2], 2u);
+
+    // Whole struct operations do not count
+    hot_cold other(obj);
+    obj.capply(noop());
+    EXPECT_TRUE(other == obj);
+
+    EXPECT_EQ(f1d::get_field_access_counts<hot_cold>(), counts);
+
+    f1d::reset_field_access_counts<hot_cold>();
+
+    EXPECT_EQ(f1d::get_field_access_counts<hot_cold>(),
+        std::vector<boost::uint64_t>(3, 0));
+}
+
+/**
+ * Test that the counts of packed structs are kept apart
+ */
+TEST(InstrumentTest, PackedCounts)
+{
+    using namespace test_instrument_packed;
+
+    f1d::reset_field_access_counts<packed_hot_cold>();
+
+    packed_hot_cold_factory f;
+    f.begin();
+    f.set_hot('h');
+    f.set_cold(1.0);
+    f.end();
+
+    packed_hot_cold obj = f.get();
+    (types::hot_f(obj))(obj);
+
+    const std::vector<boost::uint64_t> counts =
+        f1d::get_field_access_counts<packed_hot_cold>();
+
+    EXPECT_EQ(counts[0], 3u);
+    EXPECT_EQ(counts[1], 1u);
+
+    // The accessors count, the raw accessors and whole struct operations
+    // do not
+    obj.hot() = 'x';
+    const packed_hot_cold& cobj = obj;
+    EXPECT_EQ(cobj.hot(), 'x');
+    EXPECT_EQ(cobj.cold(), 1.0);
+    EXPECT_EQ(obj.raw_cold(), 1.0);
+
+    packed_hot_cold other(obj);
+    char buffer[64];
+    obj.capply(noop());
+    obj.serialize(buffer, sizeof(buffer));
+    EXPECT_TRUE(other == obj);
+    EXPECT_FALSE(other < obj);
+
+    const std::vector<boost::uint64_t> accessed =
+        f1d::get_field_access_counts<packed_hot_cold>();
+
+    EXPECT_EQ(accessed[0], 5u);
+    EXPECT_EQ(accessed[1], 2u);
+}
+
+/**
+ * Test that the counts of finished and running threads are merged
+ */
+TEST(InstrumentTest, ThreadCounts)
+{
+    using namespace test_instrument;
+
+    f1d::reset_field_access_counts<hot_cold>();
+
+    hot_cold obj = hot_cold();
+
+    std::thread worker([&obj]() {
+        for (int i = 0; i < 1000; i++)
+            types::warm_f w(obj);
+    });
+
+    worker.join();
+
+    for (int i = 0; i < 10; i++)
+        types::warm_f w(obj);
+
+    for (int i = 0; i < 5; i++)
+        obj.cvisit_field(2, noop());
+
+    const std::vector<boost::uint64_t> counts =
+        f1d::get_field_access_counts<hot_cold>();
+
+    EXPECT_EQ(counts[0], 0u);
+    EXPECT_EQ(counts[1], 1010u);
+    EXPECT_EQ(counts[2], 5u);
+}
+
+/**
+ * Test the report keyed by field name
+ */
+TEST(InstrumentTest, Report)
+{
+    using namespace test_instrument;
+
+    f1d::reset_field_access_counts<hot_cold>();
+
+    hot_cold obj = hot_cold();
+
+    for (int i = 0; i < 3; i++)
+        types::cold_f c(obj);
+
+    types::hot_f h(obj);
+
+    const f1d::field_access_report<hot_cold> report;
+
+    ASSERT_EQ(report.fields().size(), 3u);
+    EXPECT_STREQ(report.fields()[0].name, "hot");
+    EXPECT_STREQ(report.fields()[2].name, "cold");
+    EXPECT_EQ(report.count(0), 1u);
+    EXPECT_EQ(report.count(1), 0u);
+    EXPECT_EQ(report.count(2), 3u);
+    EXPECT_EQ(report.total(), 4u);
+
+    std::ostringstream out;
+    out << report;
+
+    EXPECT_EQ(out.str(),
+        "hot_cold: accesses 4\n"
+        "  [0] hot: 1\n"
+        "  [1] warm: 0\n"
+        "  [2] cold: 3\n");
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/fields.hpp>
+#include <f1d/layout.hpp>
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace test_layout {
+
+F1D_TRAITS_MAKE()
+
+F1D_STRUCT_MAKE_NT(mixed_struct,
+    ( (a, char  ) )
+    ( (b, double) )
+    ( (c, int   ) )
+    ( (d, char  ) )
+) // mixed_struct
+
+struct big
+{
+    char bytes[60];
+};
+
+F1D_STRUCT_MAKE_NT(wide_struct,
+    ( (head, double) )
+    ( (tail, big   ) )
+) // wide_struct
+
+F1D_ASSERT_FIELD_IN_CACHE_LINE(mixed_struct, b);
+F1D_ASSERT_FIELD_IN_CACHE_LINE(wide_struct, head);
+
+}
+
+/**
+ * Test the offset and alignment metadata
+ */
+TEST(LayoutTest, OffsetsAndAlignments)
+{
+    typedef test_layout::mixed_struct S;
+
+    EXPECT_EQ(S::get_field_offset(0), offsetof(S, a));
+    EXPECT_EQ(S::get_field_offset(1), offsetof(S, b));
+    EXPECT_EQ(S::get_field_offset(2), offsetof(S, c));
+    EXPECT_EQ(S::get_field_offset(3), offsetof(S, d));
+    EXPECT_THROW(S::get_field_offset(4), f1d::not_found_exception);
+
+    EXPECT_EQ(S::get_field_offsets()[1], offsetof(S, b));
+
+    EXPECT_EQ(S::get_field_alignment(0), alignof(char));
+    EXPECT_EQ(S::get_field_alignment(1), alignof(double));
+    EXPECT_EQ(S::get_field_alignment(2), alignof(int));
+    EXPECT_EQ(S::get_field_alignment(3), alignof(char));
+    EXPECT_THROW(S::get_field_alignment(4), f1d::not_found_exception);
+
+    EXPECT_EQ(S::get_field_alignments()[2], alignof(int));
+}
+
+/**
+ * Test the padding report
+ */
+TEST(LayoutTest, PaddingReport)
+{
+    typedef test_layout::mixed_struct S;
+
+    const f1d::layout_report<S> report;
+
+    EXPECT_EQ(report.struct_size(), sizeof(S));
+    EXPECT_EQ(report.packed_size(), 14);
+    EXPECT_EQ(report.padding(), sizeof(S) - 14);
+    EXPECT_EQ(report.cache_lines(), 1);
+    EXPECT_EQ(report.num_straddling(), 0);
+
+    ASSERT_EQ(report.fields().size(), 4);
+
+    EXPECT_EQ(report.fields()[0].padding, offsetof(S, b) - 1);
+    EXPECT_EQ(report.fields()[3].padding, sizeof(S) - offsetof(S, d) - 1);
+
+    std::ostringstream out;
+    out << report;
+
+    EXPECT_NE(out.str().find("mixed_struct"), std::string::npos);
+    EXPECT_NE(out.str().find("b (double)"), std::string::npos);
+    EXPECT_EQ(out.str().find("STRADDLES"), std::string::npos);
+}
+
+/**
+ * Test fields straddling cache lines
+ */
+TEST(LayoutTest, StraddlingReport)
+{
+    typedef test_layout::wide_struct S;
+
+    const f1d::layout_report<S> report;
+
+    EXPECT_EQ(report.cache_lines(), 2);
+    EXPECT_EQ(report.num_straddling(), 1);
+
+    EXPECT_FALSE(report.fields()[0].straddles());
+    EXPECT_TRUE(report.fields()[1].straddles());
+
+    const f1d::layout_report<S> report128(128);
+
+    EXPECT_EQ(report128.num_straddling(), 0);
+
+    std::ostringstream out;
+    out << report;
+
+    EXPECT_NE(out.str().find("tail (big): offset 8"), std::string::npos);
+    EXPECT_NE(out.str().find("line 0-1 STRADDLES"), std::string::npos);
+
+    EXPECT_FALSE(f1d::fits_cache_line(60, 8, 64));
+    EXPECT_TRUE (f1d::fits_cache_line(56, 8, 64));
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/mask.hpp>
+#include <gtest/gtest.h>
+
+namespace test_mask {
+
+template <unsigned int N>
+void fill_and_check()
+{
+    f1d::field_mask<N> mask;
+
+    for (unsigned int i = 0; i < N; i++) {
+        ASSERT_FALSE(mask.all());
+        ASSERT_FALSE(mask.test(i));
+        mask.set(i);
+        ASSERT_TRUE(mask.test(i));
+    }
+
+    ASSERT_TRUE(mask.all());
+
+    mask.reset();
+
+    for (unsigned int i = 0; i < N; i++)
+        ASSERT_FALSE(mask.test(i));
+
+    // Fill backwards to make sure the last word is not checked first only
+    for (unsigned int i = N; i > 0; i--) {
+        ASSERT_FALSE(mask.all());
+        mask.set(i - 1);
+    }
+
+    ASSERT_TRUE(mask.all());
+}
+
+}
+
+/**
+ * Test the mask word count
+ */
+TEST(FieldMaskTest, WordCount)
+{
+    EXPECT_EQ(f1d::field_mask<1>::num_words, 1);
+    EXPECT_EQ(f1d::field_mask<64>::num_words, 1);
+    EXPECT_EQ(f1d::field_mask<65>::num_words, 2);
+    EXPECT_EQ(f1d::field_mask<256>::num_words, 4);
+
+    EXPECT_EQ(sizeof(f1d::field_mask<3>), 8);
+    EXPECT_EQ(sizeof(f1d::field_mask<200>), 32);
+}
+
+/**
+ * Test setting every flag
+ */
+TEST(FieldMaskTest, SetAll)
+{
+    test_mask::fill_and_check<1>();
+    test_mask::fill_and_check<3>();
+    test_mask::fill_and_check<63>();
+    test_mask::fill_and_check<64>();
+    test_mask::fill_and_check<65>();
+    test_mask::fill_and_check<128>();
+    test_mask::fill_and_check<200>();
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <f1d/fields.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace test_move {
+
+/**
+ * Counts the copies and moves of a value.
+ */
+struct tracked
+{
+    static int copies;
+    static int moves;
+
+    std::string value;
+
+    tracked()
+    {
+    }
+
+    tracked(const char* value, size_t length) :
+        value(value, length)
+    {
+    }
+
+    tracked(const std::string& value) :
+        value(value)
+    {
+    }
+
+    tracked(const tracked& other) :
+        value(other.value)
+    {
+        copies++;
+    }
+
+    tracked(tracked&& other) noexcept :
+        value(std::move(other.value))
+    {
+        moves++;
+    }
+
+    tracked& operator =(const tracked& other)
+    {
+        value = other.value;
+        copies++;
+        return *this;
+    }
+
+    tracked& operator =(tracked&& other) noexcept
+    {
+        value = std::move(other.value);
+        moves++;
+        return *this;
+    }
+
+    static void reset()
+    {
+        copies = 0;
+        moves = 0;
+    }
+};
+
+int tracked::copies = 0;
+int tracked::moves = 0;
+
+}
+
+namespace f1d {
+
+template <>
+struct serializer<test_move::tracked>
+{
+    static size_t size(const test_move::tracked& t)
+    {
+        return serializer<std::string>::size(t.value);
+    }
+
+    static char* write(const test_move::tracked& t, char* out)
+    {
+        return serializer<std::string>::write(t.value, out);
+    }
+
+    static const char* read(test_move::tracked& t, const char* in,
+        const char* end)
+    {
+        return serializer<std::string>::read(t.value, in, end);
+    }
+};
+
+}
+
+namespace test_move {
+
+F1D_STRUCT_MAKE(record,
+    ( (id,      int                 ) )
+    ( (payload, tracked             ) )
+    ( (values,  std::vector<double> ) )
+) // record
+
+template <typename F, typename T, typename Enable = void>
+struct can_emplace_id :
+    std::false_type
+{
+};
+
+template <typename F, typename T>
+struct can_emplace_id<F, T,
+    decltype(void(std::declval<F&>().emplace_id(std::declval<T>())))> :
+    std::true_type
+{
+};
+
+template <typename F, typename T, typename Enable = void>
+struct can_try_emplace_id :
+    std::false_type
+{
+};
+
+template <typename F, typename T>
+struct can_try_emplace_id<F, T,
+    decltype(void(std::declval<F&>().try_emplace_id(std::declval<T>())))> :
+    std::true_type
+{
+};
+
+}
+
+/**
+ * Test that rvalue setters move into the factory
+ */
+TEST(MoveTest, FactorySetRvalue)
+{
+    using namespace test_move;
+
+    record_factory f;
+    tracked payload(std::string("payload"));
+    std::vector<double> values(1000, 1.5);
+    const double* data = values.data();
+
+    tracked::reset();
+
+    f.begin();
+    f.set_id(1);
+    f.set_payload(std::move(payload));
+    f.set_values(std::move(values));
+    f.end();
+
+    EXPECT_EQ(tracked::copies, 0);
+    EXPECT_EQ(tracked::moves, 1);
+    EXPECT_EQ(f.get().payload.value, "payload");
+    EXPECT_EQ(f.get().values.data(), data);
+}
+
+/**
+ * Test constructing fields from their constructor arguments
+ */
+TEST(MoveTest, FactoryEmplace)
+{
+    using namespace test_move;
+
+    record_factory f;
+
+    tracked::reset();
+
+    f.begin();
+    f.emplace_id(7);
+    f.emplace_payload("abcdef", 3);
+    f.emplace_values(4, 2.5);
+    EXPECT_THROW(f.emplace_values(1, 1.0), f1d::already_set_exception);
+    f.end();
+
+    EXPECT_EQ(f.try_emplace_id(8), f1d::already_finished_error);
+    EXPECT_EQ(tracked::copies, 0);
+    EXPECT_EQ(tracked::moves, 1);
+    EXPECT_EQ(f.get().id, 7);
+    EXPECT_EQ(f.get().payload.value, "abc");
+    EXPECT_EQ(f.get().values, std::vector<double>(4, 2.5));
+}
+
+/**
+ * Test that emplace only accepts arguments the field can be
+ * direct-initialized from
+ */
+TEST(MoveTest, FactoryEmplaceArguments)
+{
+    using namespace test_move;
+
+    EXPECT_TRUE((can_emplace_id<record_factory, int>::value));
+    EXPECT_TRUE((can_emplace_id<record_factory, double>::value));
+    EXPECT_FALSE((can_emplace_id<record_factory, const char*>::value));
+    EXPECT_FALSE((can_emplace_id<record_factory, std::string>::value));
+
+    EXPECT_TRUE((can_try_emplace_id<record_factory, int>::value));
+    EXPECT_FALSE((can_try_emplace_id<record_factory, const char*>::value));
+}
+
+/**
+ * Test moving the finished struct out of the factory
+ */
+TEST(MoveTest, FactoryTake)
+{
+    using namespace test_move;
+
+    record_factory f;
+
+    EXPECT_THROW(f.take(), f1d::not_intialized_exception);
+
+    f.begin();
+    f.set_id(1);
+    f.emplace_payload(std::string("heavy"));
+    f.emplace_values(100, 0.5);
+
+    EXPECT_THROW(f.take(), f1d::not_finished_exception);
+
+    f.end();
+
+    tracked::reset();
+
+    record r = f.take();
+
+    EXPECT_EQ(tracked::copies, 0);
+    EXPECT_EQ(r.payload.value, "heavy");
+    EXPECT_EQ(r.values.size(), 100u);
+
+    EXPECT_THROW(f.get(), f1d::not_intialized_exception);
+    EXPECT_THROW(f.take(), f1d::not_intialized_exception);
+
+    f.begin();
+    f.set_id(2);
+    f.set_payload(tracked(std::string("next")));
+    f.set_values(std::vector<double>());
+    f.end();
+
+    EXPECT_EQ(f.take().payload.value, "next");
+}
+
+/**
+ * Test moving field wrappers and moving their values into structs
+ */
+TEST(MoveTest, WrapperMove)
+{
+    using namespace test_move;
+
+    record r;
+    r.payload = tracked(std::string("source"));
+
+    tracked::reset();
+
+    types::payload_f w1(r);
+    types::payload_f w2(std::move(w1));
+    types::payload_f w3;
+
+    w3 = std::move(w2);
+
+    EXPECT_EQ(tracked::copies, 1);
+    EXPECT_EQ(w3.get().value, "source");
+
+    record target;
+
+    tracked::reset();
+
+    w3(target);
+    EXPECT_EQ(tracked::copies, 1);
+
+    std::move(w3)(target);
+    EXPECT_EQ(tracked::copies, 1);
+    EXPECT_EQ(tracked::moves, 1);
+    EXPECT_EQ(target.payload.value, "source");
+
+    tracked::reset();
+
+    types::payload_f w4(tracked(std::string("value")));
+    tracked v = std::move(w4);
+
+    EXPECT_EQ(tracked::copies, 0);
+    EXPECT_EQ(v.value, "value");
+
+    types::values_f w5(std::vector<double>(10, 1.0));
+    const double* data = w5.get().data();
+    std::vector<double> values;
+
+    std::move(w5)(values);
+    EXPECT_EQ(values.data(), data);
+
+    types::values_f w6(std::vector<double>(10, 2.0));
+    data = w6.get().data();
+
+    std::move(w6).set_member(target);
+    EXPECT_EQ(target.values.data(), data);
+}
+
+/**
+ * Test moving wrapper values into a factory
+ */
+TEST(MoveTest, WrapperFactory)
+{
+    using namespace test_move;
+
+    record_factory f;
+
+    types::id_f id(3);
+    types::payload_f payload(tracked(std::string("p")));
+    types::values_f values(std::vector<double>(5, 1.0));
+
+    tracked::reset();
+
+    f.begin();
+    id(f);
+    std::move(payload)(f);
+    std::move(values)(f);
+    f.end();
+
+    EXPECT_EQ(tracked::copies, 0);
+    EXPECT_EQ(f.get().payload.value, "p");
+    EXPECT_EQ(f.get().values.size(), 5u);
+}
+
+/**
+ * Test the noexcept specifications, so vectors of wrappers move their
+ * elements when they grow
+ */
+TEST(MoveTest, WrapperNoexcept)
+{
+    using namespace test_move;
+
+    EXPECT_TRUE(std::is_nothrow_move_constructible<types::payload_f>::value);
+    EXPECT_TRUE(std::is_nothrow_move_assignable<types::payload_f>::value);
+    EXPECT_TRUE(std::is_nothrow_move_constructible<types::values_f>::value);
+    EXPECT_TRUE(std::is_nothrow_copy_constructible<types::id_f>::value);
+    EXPECT_FALSE(std::is_nothrow_copy_constructible<types::payload_f>::value);
+
+    std::vector<types::payload_f> wrappers(1);
+
+    tracked::reset();
+
+    for (int i = 0; i < 100; i++)
+        wrappers.push_back(types::payload_f(tracked(std::string("x"))));
+
+    EXPECT_EQ(tracked::copies, 0);
+}
@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/fields.hpp>
+#include <f1d/layout.hpp>
+#include <f1d/soa.hpp>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#define TEST_PACKED_FIELDS \
+    ( (a, char  ) ) \
+    ( (b, double) ) \
+    ( (c, int   ) ) \
+    ( (d, char  ) ) \
+    ( (e, short ) )
+
+namespace test_packed {
+
+F1D_STRUCT_MAKE_PACKED(packed_struct, TEST_PACKED_FIELDS)
+F1D_SOA_MAKE_PACKED(packed_struct, TEST_PACKED_FIELDS)
+
+namespace plain {
+
+F1D_STRUCT_MAKE(plain_struct, TEST_PACKED_FIELDS)
+
+}
+
+struct index_collector
+{
+    std::vector<unsigned int> indices;
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V&)
+    {
+        indices.push_back(I);
+    }
+};
+
+template <typename T, typename Enable = void>
+struct has_public_storage :
+    std::false_type
+{
+};
+
+template <typename T>
+struct has_public_storage<T, decltype(void(&T::_fields))> :
+    std::true_type
+{
+};
+
+}
+
+/**
+ * Test that the packed struct is smaller than the plain one
+ */
+TEST(PackedTest, Size)
+{
+    typedef test_packed::packed_struct S;
+
+    EXPECT_LT(sizeof(S), sizeof(test_packed::plain::plain_struct));
+    EXPECT_EQ(sizeof(S), static_cast<size_t>(S::packed_size));
+
+    f1d::layout_report<S> report;
+
+    EXPECT_EQ(report.padding(), 0u);
+}
+
+/**
+ * Test that the logical metadata follows the declaration order
+ */
+TEST(PackedTest, Metadata)
+{
+    typedef test_packed::packed_struct S;
+
+    EXPECT_EQ(static_cast<unsigned int>(S::num_fields), 5u);
+    EXPECT_STREQ(S::get_field_name(0), "a");
+    EXPECT_STREQ(S::get_field_name(1), "b");
+    EXPECT_STREQ(S::get_field_name(4), "e");
+    EXPECT_EQ(S::get_field_index("c"), 2u);
+    EXPECT_EQ(S::get_type_size(1), sizeof(double));
+
+    bool same = std::is_same<
+        test_packed::traits::value_type<S, 1>::type, double>::value;
+    EXPECT_TRUE(same);
+
+    same = std::is_same<
+        test_packed::traits::field_wrapper_type<S, 4>::type,
+        test_packed::types::e_f>::value;
+    EXPECT_TRUE(same);
+}
+
+/**
+ * Test that the offsets match the physical placement of the fields
+ */
+TEST(PackedTest, Offsets)
+{
+    typedef test_packed::packed_struct S;
+
+    S s;
+    const char* base = reinterpret_cast<const char*>(&s);
+
+    EXPECT_EQ(S::get_field_offset(0),
+        static_cast<size_t>(reinterpret_cast<const char*>(&s.a()) - base));
+    EXPECT_EQ(S::get_field_offset(1),
+        static_cast<size_t>(reinterpret_cast<const char*>(&s.b()) - base));
+    EXPECT_EQ(S::get_field_offset(2),
+        static_cast<size_t>(reinterpret_cast<const char*>(&s.c()) - base));
+    EXPECT_EQ(S::get_field_offset(3),
+        static_cast<size_t>(reinterpret_cast<const char*>(&s.d()) - base));
+    EXPECT_EQ(S::get_field_offset(4),
+        static_cast<size_t>(reinterpret_cast<const char*>(&s.e()) - base));
+
+    EXPECT_EQ(S::get_field_offset(1), 0u);
+    EXPECT_EQ(S::get_field_offset(2), sizeof(double));
+
+    EXPECT_FALSE(test_packed::has_public_storage<S>::value);
+}
+
+/**
+ * Test the accessors, apply order, factory and wrappers
+ */
+TEST(PackedTest, Access)
+{
+    using namespace test_packed;
+
+    packed_struct s;
+
+    s.a() = 'x';
+    s.b() = 1.5;
+    s.c() = -7;
+    s.d() = 'y';
+    s.e() = 42;
+
+    const packed_struct& cs = s;
+
+    EXPECT_EQ(cs.a(), 'x');
+    EXPECT_EQ(cs.b(), 1.5);
+    EXPECT_EQ(cs.c(), -7);
+    EXPECT_EQ(cs.d(), 'y');
+    EXPECT_EQ(cs.e(), 42);
+
+    index_collector collector;
+    s.capply(collector);
+
+    ASSERT_EQ(collector.indices.size(), 5u);
+    for (unsigned int i = 0; i < 5; i++)
+        EXPECT_EQ(collector.indices[i], i);
+
+    types::c_f c(s);
+    EXPECT_EQ(c.get(), -7);
+
+    packed_struct_factory factory;
+
+    factory.begin();
+    factory.set_a('p');
+    factory.set_b(2.5);
+    factory.set_c(3);
+    factory.set_d('q');
+    types::e_f(5)(factory);
+    factory.end();
+
+    const packed_struct& built = factory.get();
+
+    EXPECT_EQ(built.a(), 'p');
+    EXPECT_EQ(built.b(), 2.5);
+    EXPECT_EQ(built.c(), 3);
+    EXPECT_EQ(built.d(), 'q');
+    EXPECT_EQ(built.e(), 5);
+    EXPECT_EQ(factory.get_c(), 3);
+}
+
+/**
+ * Test setting the fields of packed structs through the field wrappers
+ */
+TEST(PackedTest, Wrappers)
+{
+    using namespace test_packed;
+
+    packed_struct s;
+    plain::plain_struct p;
+
+    types::a_f('w')(s);
+    types::b_f(0.25)(s);
+    types::c_f(9).set_member(s);
+    types::d_f('z').set_member(s);
+
+    types::e_f e(7);
+    std::move(e).set_member(s);
+
+    EXPECT_EQ(s.a(), 'w');
+    EXPECT_EQ(s.b(), 0.25);
+    EXPECT_EQ(s.c(), 9);
+    EXPECT_EQ(s.d(), 'z');
+    EXPECT_EQ(s.e(), 7);
+
+    // Other structs with the same member names are set directly
+    types::c_f(11).set_member(p);
+    EXPECT_EQ(p.c, 11);
+}
+
+/**
+ * Test serialization and SoA storage of packed structs
+ */
+TEST(PackedTest, SerializeAndSoA)
+{
+    using namespace test_packed;
+
+    packed_struct s;
+
+    s.a() = 'x';
+    s.b() = 1.5;
+    s.c() = -7;
+    s.d() = 'y';
+    s.e() = 42;
+
+    char buffer[sizeof(packed_struct)];
+    EXPECT_EQ(s.serialize(buffer, sizeof(buffer)), sizeof(packed_struct));
+
+    packed_struct r;
+    r.deserialize(buffer, sizeof(buffer));
+
+    EXPECT_EQ(r.b(), 1.5);
+    EXPECT_EQ(r.e(), 42);
+
+    EXPECT_FALSE(f1d::is_bulk_serializable<packed_struct>::value);
+
+    packed_struct_soa soa;
+    soa.push_back(s);
+
+    EXPECT_EQ(soa.size(), 1u);
+    EXPECT_EQ(soa.c[0], -7);
+
+    s.c() = 9;
+    soa[0] = s;
+
+    packed_struct t = soa[0];
+
+    EXPECT_EQ(t.a(), 'x');
+    EXPECT_EQ(t.c(), 9);
+}
+
+/**
+ * Test that plain and packed structs share the wire format
+ */
+TEST(PackedTest, SerializeAcrossLayouts)
+{
+    using namespace test_packed;
+
+    plain::plain_struct p;
+
+    p.a = 'x';
+    p.b = 1.5;
+    p.c = -7;
+    p.d = 'y';
+    p.e = 42;
+
+    char buffer[64];
+    const size_t written = p.serialize(buffer, sizeof(buffer));
+
+    EXPECT_EQ(written, p.get_serialized_size());
+
+    packed_struct s;
+    EXPECT_EQ(s.deserialize(buffer, written), written);
+
+    EXPECT_EQ(s.a(), 'x');
+    EXPECT_EQ(s.b(), 1.5);
+    EXPECT_EQ(s.c(), -7);
+    EXPECT_EQ(s.d(), 'y');
+    EXPECT_EQ(s.e(), 42);
+
+    char round_trip[64];
+    ASSERT_EQ(s.serialize(round_trip, sizeof(round_trip)), written);
+    EXPECT_EQ(std::memcmp(buffer, round_trip, written), 0);
+
+    plain::plain_struct q;
+    EXPECT_EQ(q.deserialize(round_trip, written), written);
+
+    EXPECT_TRUE(q == p);
+}
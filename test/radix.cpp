@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <f1d/radix.hpp>
+#include <f1d/soa.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#define RADIX_TEST_FIELDS \
+    ( (id,     int        ) ) \
+    ( (score,  double     ) ) \
+    ( (weight, float      ) ) \
+    ( (bucket, unsigned   ) ) \
+    ( (offset, long long  ) ) \
+    ( (name,   std::string) )
+
+namespace test_radix {
+
+F1D_STRUCT_MAKE(row, RADIX_TEST_FIELDS)
+
+F1D_SOA_MAKE(row, RADIX_TEST_FIELDS)
+
+std::vector<row> make_rows(size_t n)
+{
+    std::vector<row> rows(n);
+
+    std::srand(1234);
+
+    for (size_t i = 0; i < n; i++) {
+        rows[i].id = static_cast<int>(i);
+        rows[i].score = (std::rand() % 2001 - 1000) / 8.0;
+        rows[i].weight = (std::rand() % 201 - 100) / 4.0f;
+        rows[i].bucket = std::rand() % 4;
+        rows[i].offset = (static_cast<long long>(std::rand()) << 20) *
+            (std::rand() % 2 ? 1 : -1);
+        rows[i].name = std::to_string(i);
+    }
+
+    rows[0].score = -0.0;
+    rows[1].score = std::numeric_limits<double>::infinity();
+    rows[2].score = -std::numeric_limits<double>::infinity();
+    rows[3].offset = std::numeric_limits<long long>::min();
+    rows[4].offset = std::numeric_limits<long long>::max();
+
+    return rows;
+}
+
+}
+
+/**
+ * Test the order preserving key transforms
+ */
+TEST(RadixTest, Keys)
+{
+    typedef f1d::radix_key<int> ikey;
+    typedef f1d::radix_key<double> dkey;
+    typedef f1d::radix_key<float> fkey;
+
+    EXPECT_LT(ikey::get(-5), ikey::get(-1));
+    EXPECT_LT(ikey::get(-1), ikey::get(0));
+    EXPECT_LT(ikey::get(0), ikey::get(7));
+
+    EXPECT_LT(dkey::get(-2.5), dkey::get(-1.0));
+    EXPECT_LT(dkey::get(-1.0), dkey::get(-0.0));
+    EXPECT_LT(dkey::get(-0.0), dkey::get(0.0));
+    EXPECT_LT(dkey::get(0.0), dkey::get(1e-300));
+    EXPECT_LT(dkey::get(1.0), dkey::get(1e300));
+
+    EXPECT_LT(fkey::get(-1.5f), fkey::get(0.25f));
+}
+
+/**
+ * Test sorting a vector of structs by a single key of each type
+ */
+TEST(RadixTest, SortVector)
+{
+    using namespace test_radix;
+
+    const std::vector<row> rows = make_rows(1000);
+
+    std::vector<row> sorted = rows;
+    std::vector<row> expected = rows;
+
+    f1d::radix_sort<types::score_f>(sorted);
+    std::stable_sort(expected.begin(), expected.end(),
+        f1d::compare_by<types::score_f>());
+
+    for (size_t i = 0; i < rows.size(); i++)
+        EXPECT_EQ(sorted[i].id, expected[i].id);
+
+    sorted = rows;
+    expected = rows;
+
+    f1d::radix_sort<types::weight_f>(sorted);
+    std::stable_sort(expected.begin(), expected.end(),
+        f1d::compare_by<types::weight_f>());
+
+    for (size_t i = 0; i < rows.size(); i++)
+        EXPECT_EQ(sorted[i].id, expected[i].id);
+
+    sorted = rows;
+    expected = rows;
+
+    f1d::radix_sort<types::offset_f>(sorted);
+    std::stable_sort(expected.begin(), expected.end(),
+        f1d::compare_by<types::offset_f>());
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        EXPECT_EQ(sorted[i].id, expected[i].id);
+        EXPECT_EQ(sorted[i].name, expected[i].name);
+    }
+}
+
+/**
+ * Test sorting by two keys
+ */
+TEST(RadixTest, SortTwoKeys)
+{
+    using namespace test_radix;
+
+    const std::vector<row> rows = make_rows(1000);
+
+    std::vector<row> sorted = rows;
+    std::vector<row> expected = rows;
+
+    f1d::radix_sort<types::bucket_f, types::weight_f>(sorted);
+    std::stable_sort(expected.begin(), expected.end(),
+        f1d::compare_by<types::bucket_f, types::weight_f>());
+
+    for (size_t i = 0; i < rows.size(); i++)
+        EXPECT_EQ(sorted[i].id, expected[i].id);
+}
+
+/**
+ * Test sorting an SoA container
+ */
+TEST(RadixTest, SortSoA)
+{
+    using namespace test_radix;
+
+    const std::vector<row> rows = make_rows(500);
+
+    row_soa soa;
+    std::vector<row> expected = rows;
+
+    for (size_t i = 0; i < rows.size(); i++)
+        soa.push_back(rows[i]);
+
+    f1d::radix_sort<types::bucket_f, types::score_f>(soa);
+    std::stable_sort(expected.begin(), expected.end(),
+        f1d::compare_by<types::bucket_f, types::score_f>());
+
+    ASSERT_EQ(soa.size(), expected.size());
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        EXPECT_EQ(soa.id[i], expected[i].id);
+        EXPECT_EQ(soa.weight[i], expected[i].weight);
+        EXPECT_EQ(soa.name[i], expected[i].name);
+    }
+}
+
+/**
+ * Test computing the permutation without moving the records
+ */
+TEST(RadixTest, Permutation)
+{
+    using namespace test_radix;
+
+    const std::vector<row> rows = make_rows(300);
+
+    std::vector<size_t> order;
+    f1d::radix_sort_permutation<types::offset_f>(rows, order);
+
+    ASSERT_EQ(order.size(), rows.size());
+    EXPECT_EQ(order.front(), 3u);
+    EXPECT_EQ(order.back(), 4u);
+
+    for (size_t i = 1; i < order.size(); i++) {
+        EXPECT_LE(rows[order[i - 1]].offset, rows[order[i]].offset);
+        if (rows[order[i - 1]].offset == rows[order[i]].offset) {
+            EXPECT_LT(order[i - 1], order[i]);
+        }
+    }
+
+    std::vector<row> empty;
+    f1d::radix_sort_permutation<types::id_f>(empty, order);
+    EXPECT_TRUE(order.empty());
+}
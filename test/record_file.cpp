@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/record_file.hpp>
+#include <f1d/soa.hpp>
+#include <gtest/gtest.h>
+
+#include <boost/cstdint.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <type_traits>
+#include <utility>
+
+#define RECORD_TEST_FIELDS \
+    ( (id,    long  ) ) \
+    ( (value, double) ) \
+    ( (flag,  char  ) )
+
+namespace test_record_file {
+
+F1D_TRAITS_MAKE()
+
+F1D_STRUCT_MAKE_NT(record_struct, RECORD_TEST_FIELDS)
+
+F1D_SOA_MAKE(record_struct, RECORD_TEST_FIELDS)
+
+namespace other {
+
+F1D_STRUCT_MAKE(other_struct,
+    ( (id,    long  ) )
+    ( (value, float ) )
+    ( (flag,  char  ) )
+) // other_struct
+
+}
+
+std::vector<record_struct> make_records(size_t n)
+{
+    std::vector<record_struct> records(n);
+
+    for (size_t i = 0; i < n; i++) {
+        records[i].id = 1000 + i;
+        records[i].value = 0.5 * i;
+        records[i].flag = 'a' + i % 26;
+    }
+
+    return records;
+}
+
+template <typename S, typename Field, typename Enable = void>
+struct has_column :
+    std::false_type
+{
+};
+
+template <typename S, typename Field>
+struct has_column<S, Field,
+    decltype(void(std::declval<const f1d::record_file<S>&>()
+        .template column<Field>()))> :
+    std::true_type
+{
+};
+
+struct temp_path
+{
+    std::string path;
+
+    temp_path(const char* name) :
+        path(std::string(P_tmpdir) + "/" + name)
+    {
+    }
+
+    ~temp_path()
+    {
+        std::remove(path.c_str());
+    }
+};
+
+}
+
+/**
+ * Test writing and mapping a file with the AoS layout
+ */
+TEST(RecordFileTest, AoSRoundTrip)
+{
+    test_record_file::temp_path tmp("f1d_record_file_aos.bin");
+    const std::vector<test_record_file::record_struct> records =
+        test_record_file::make_records(100);
+
+    f1d::write_record_file(tmp.path, records.begin(), records.end());
+
+    f1d::record_file<test_record_file::record_struct> file(tmp.path);
+
+    ASSERT_EQ(file.layout(), f1d::aos_layout);
+    ASSERT_EQ(file.size(), 100);
+    EXPECT_EQ(reinterpret_cast<size_t>(file.data()) % 64, 0);
+
+    size_t i = 0;
+
+    for (const test_record_file::record_struct* it = file.begin();
+        it != file.end(); ++it, ++i) {
+        EXPECT_EQ(it->id, records[i].id);
+        EXPECT_EQ(it->value, records[i].value);
+        EXPECT_EQ(it->flag, records[i].flag);
+    }
+
+    EXPECT_EQ(i, 100);
+    EXPECT_EQ(file[42].id, 1042);
+}
+
+/**
+ * Test writing and mapping a file with the SoA layout
+ */
+TEST(RecordFileTest, SoARoundTrip)
+{
+    test_record_file::temp_path tmp1("f1d_record_file_soa1.bin");
+    test_record_file::temp_path tmp2("f1d_record_file_soa2.bin");
+    const std::vector<test_record_file::record_struct> records =
+        test_record_file::make_records(77);
+
+    test_record_file::record_struct_soa soa;
+
+    for (size_t i = 0; i < records.size(); i++)
+        soa.push_back(records[i]);
+
+    f1d::write_record_file(tmp1.path, records.begin(), records.end(),
+        f1d::soa_layout);
+    f1d::write_record_file(tmp2.path, soa);
+
+    const char* paths[] = { tmp1.path.c_str(), tmp2.path.c_str() };
+
+    for (size_t p = 0; p < 2; p++) {
+
+        f1d::record_file<test_record_file::record_struct> file(paths[p]);
+
+        ASSERT_EQ(file.layout(), f1d::soa_layout);
+        ASSERT_EQ(file.size(), 77);
+
+        const long* ids = file.column<test_record_file::types::id_f>();
+        const double* values = file.column<test_record_file::types::value_f>();
+        const char* flags = file.column<test_record_file::types::flag_f>();
+
+        EXPECT_EQ(reinterpret_cast<size_t>(values) % 64, 0);
+
+        for (size_t i = 0; i < records.size(); i++) {
+            EXPECT_EQ(ids[i], records[i].id);
+            EXPECT_EQ(values[i], records[i].value);
+            EXPECT_EQ(flags[i], records[i].flag);
+        }
+    }
+}
+
+/**
+ * Test mapping a file written from a different struct
+ */
+TEST(RecordFileTest, HeaderMismatch)
+{
+    test_record_file::temp_path tmp("f1d_record_file_mismatch.bin");
+    const std::vector<test_record_file::record_struct> records =
+        test_record_file::make_records(3);
+
+    f1d::write_record_file(tmp.path, records.begin(), records.end());
+
+    EXPECT_THROW(f1d::record_file<test_record_file::other::other_struct> file(tmp.path),
+        f1d::format_exception);
+
+    try {
+        f1d::record_file<test_record_file::other::other_struct> file(tmp.path);
+    }
+    catch (const std::exception& ex) {
+
+        const std::string* what;
+        what = boost::get_error_info<f1d::header_field>(ex);
+
+        ASSERT_TRUE(what != 0);
+    }
+}
+
+/**
+ * Test mapping invalid files
+ */
+TEST(RecordFileTest, InvalidFile)
+{
+    test_record_file::temp_path tmp("f1d_record_file_invalid.bin");
+
+    EXPECT_THROW(f1d::record_file<test_record_file::record_struct> file(tmp.path),
+        f1d::io_exception);
+
+    const std::vector<test_record_file::record_struct> records =
+        test_record_file::make_records(10);
+
+    f1d::write_record_file(tmp.path, records.begin(), records.end());
+
+    // Truncate the data section
+    ASSERT_EQ(truncate(tmp.path.c_str(), 200), 0);
+
+    EXPECT_THROW(f1d::record_file<test_record_file::record_struct> file(tmp.path),
+        f1d::format_exception);
+
+    ASSERT_EQ(truncate(tmp.path.c_str(), 0), 0);
+
+    EXPECT_THROW(f1d::record_file<test_record_file::record_struct> file(tmp.path),
+        f1d::format_exception);
+}
+
+/**
+ * Test mapping files whose record count overflows the data size
+ */
+TEST(RecordFileTest, OverflowingCount)
+{
+    test_record_file::temp_path tmp("f1d_record_file_overflow.bin");
+    const std::vector<test_record_file::record_struct> records =
+        test_record_file::make_records(10);
+
+    const f1d::record_layout layouts[] = { f1d::aos_layout, f1d::soa_layout };
+
+    for (size_t l = 0; l < 2; l++) {
+
+        f1d::write_record_file(tmp.path, records.begin(), records.end(),
+            layouts[l]);
+
+        // Multiplied by the size of the struct or of any column, this
+        // count wraps around to a size that fits in the file
+        const boost::uint64_t count = (1ULL << 61) + 1;
+
+        std::fstream file(tmp.path.c_str(),
+            std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(24);
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.close();
+
+        EXPECT_THROW(f1d::record_file<test_record_file::record_struct>
+            mapped(tmp.path), f1d::format_exception);
+    }
+}
+
+/**
+ * Test writing the SoA layout from a range that is not contiguous
+ */
+TEST(RecordFileTest, SoAFromList)
+{
+    test_record_file::temp_path tmp("f1d_record_file_list.bin");
+    const std::vector<test_record_file::record_struct> records =
+        test_record_file::make_records(50);
+    const std::list<test_record_file::record_struct> list(
+        records.begin(), records.end());
+
+    f1d::write_record_file(tmp.path, list.begin(), list.end(),
+        f1d::soa_layout);
+
+    f1d::record_file<test_record_file::record_struct> file(tmp.path);
+
+    ASSERT_EQ(file.size(), 50);
+
+    const long* ids = file.column<test_record_file::types::id_f>();
+    const char* flags = file.column<test_record_file::types::flag_f>();
+
+    for (size_t i = 0; i < records.size(); i++) {
+        EXPECT_EQ(ids[i], records[i].id);
+        EXPECT_EQ(flags[i], records[i].flag);
+    }
+}
+
+/**
+ * Test accessing a file through the accessors of the other layout
+ */
+TEST(RecordFileTest, LayoutMismatch)
+{
+    test_record_file::temp_path tmp("f1d_record_file_layout.bin");
+    const std::vector<test_record_file::record_struct> records =
+        test_record_file::make_records(5);
+
+    f1d::write_record_file(tmp.path, records.begin(), records.end());
+
+    {
+        f1d::record_file<test_record_file::record_struct> file(tmp.path);
+
+        EXPECT_THROW(file.column<test_record_file::types::id_f>(),
+            f1d::format_exception);
+    }
+
+    f1d::write_record_file(tmp.path, records.begin(), records.end(),
+        f1d::soa_layout);
+
+    {
+        f1d::record_file<test_record_file::record_struct> file(tmp.path);
+
+        EXPECT_THROW(file.data(), f1d::format_exception);
+        EXPECT_THROW(file.begin(), f1d::format_exception);
+        EXPECT_THROW(file.end(), f1d::format_exception);
+        EXPECT_THROW(file[0], f1d::format_exception);
+    }
+}
+
+/**
+ * Test that only the field wrappers of the mapped struct select columns
+ */
+TEST(RecordFileTest, ColumnField)
+{
+    using namespace test_record_file;
+
+    EXPECT_TRUE((has_column<record_struct, types::id_f>::value));
+    EXPECT_FALSE((has_column<record_struct, other::types::id_f>::value));
+    EXPECT_FALSE((has_column<other::other_struct, types::value_f>::value));
+}
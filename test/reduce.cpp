@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <f1d/reduce.hpp>
+#include <f1d/soa.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#define REDUCE_TEST_FIELDS \
+    ( (count,  int          ) ) \
+    ( (price,  double       ) ) \
+    ( (weight, float        ) ) \
+    ( (flags,  unsigned char) )
+
+namespace test_reduce {
+
+F1D_STRUCT_MAKE(sample, REDUCE_TEST_FIELDS)
+
+F1D_SOA_MAKE(sample, REDUCE_TEST_FIELDS)
+
+std::vector<sample> make_samples(int n)
+{
+    std::vector<sample> samples(n);
+
+    for (int i = 0; i < n; i++) {
+        samples[i].count = (i % 2 ? -1 : 1) * i;
+        samples[i].price = i * 0.25;
+        samples[i].weight = 1.0f;
+        samples[i].flags = static_cast<unsigned char>(i);
+    }
+
+    return samples;
+}
+
+struct is_odd
+{
+    bool operator ()(int value) const
+    {
+        return value % 2 != 0;
+    }
+};
+
+}
+
+/**
+ * Test the reductions over a vector of structs
+ */
+TEST(ReduceTest, Vector)
+{
+    using namespace test_reduce;
+
+    const std::vector<sample> samples = make_samples(1003);
+
+    EXPECT_EQ(f1d::sum<types::count_f>(samples), 501);
+    EXPECT_DOUBLE_EQ(f1d::sum<types::price_f>(samples), 1002 * 1003 / 8.0);
+    EXPECT_DOUBLE_EQ(f1d::sum<types::weight_f>(samples), 1003.0);
+    EXPECT_EQ(f1d::sum<types::flags_f>(samples), 125415u);
+
+    EXPECT_EQ(f1d::min<types::count_f>(samples), -1001);
+    EXPECT_EQ(f1d::max<types::count_f>(samples), 1002);
+    EXPECT_EQ(f1d::max<types::flags_f>(samples), 255);
+    EXPECT_DOUBLE_EQ(f1d::min<types::price_f>(samples), 0.0);
+    EXPECT_DOUBLE_EQ(f1d::mean<types::price_f>(samples), 1002 / 8.0);
+
+    EXPECT_EQ(f1d::count_if<types::count_f>(samples, is_odd()), 501u);
+}
+
+/**
+ * Test the reductions over an SoA container
+ */
+TEST(ReduceTest, SoA)
+{
+    using namespace test_reduce;
+
+    const std::vector<sample> samples = make_samples(37);
+
+    sample_soa soa;
+
+    for (size_t i = 0; i < samples.size(); i++)
+        soa.push_back(samples[i]);
+
+    EXPECT_EQ(f1d::sum<types::count_f>(soa),
+        f1d::sum<types::count_f>(samples));
+    EXPECT_DOUBLE_EQ(f1d::sum<types::price_f>(soa),
+        f1d::sum<types::price_f>(samples));
+    EXPECT_EQ(f1d::min<types::count_f>(soa), -35);
+    EXPECT_EQ(f1d::max<types::count_f>(soa), 36);
+    EXPECT_DOUBLE_EQ(f1d::mean<types::weight_f>(soa), 1.0);
+    EXPECT_EQ(f1d::count_if<types::count_f>(soa, is_odd()), 18u);
+}
+
+/**
+ * Test the reductions over empty containers
+ */
+TEST(ReduceTest, Empty)
+{
+    using namespace test_reduce;
+
+    const std::vector<sample> samples;
+    int count = 7;
+    double mean = 7;
+
+    EXPECT_EQ(f1d::sum<types::count_f>(samples), 0);
+    EXPECT_EQ(f1d::count_if<types::count_f>(samples, is_odd()), 0u);
+
+    EXPECT_EQ(f1d::try_min<types::count_f>(samples, count),
+        f1d::not_found_error);
+    EXPECT_EQ(f1d::try_max<types::count_f>(samples, count),
+        f1d::not_found_error);
+    EXPECT_EQ(f1d::try_mean<types::count_f>(samples, mean),
+        f1d::not_found_error);
+    EXPECT_EQ(count, 7);
+
+    EXPECT_THROW(f1d::min<types::count_f>(samples), f1d::not_found_exception);
+    EXPECT_THROW(f1d::max<types::price_f>(samples), f1d::not_found_exception);
+    EXPECT_THROW(f1d::mean<types::price_f>(samples),
+        f1d::not_found_exception);
+}
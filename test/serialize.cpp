@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/fields.hpp>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace test_serialize {
+
+F1D_TRAITS_MAKE()
+
+F1D_STRUCT_MAKE_NT(dense_struct,
+    ( (a, int  ) )
+    ( (b, int  ) )
+    ( (c, float) )
+) // dense_struct
+
+F1D_STRUCT_MAKE_NT(padded_struct,
+    ( (d, char  ) )
+    ( (e, double) )
+    ( (f, short ) )
+) // padded_struct
+
+F1D_STRUCT_MAKE_NT(heavy_struct,
+    ( (g, std::string             ) )
+    ( (h, double                  ) )
+    ( (i, std::vector<int>        ) )
+    ( (j, std::vector<std::string>) )
+) // heavy_struct
+
+typedef std::map<std::string, int> string_map;
+
+F1D_STRUCT_MAKE_NT(map_struct,
+    ( (k, int       ) )
+    ( (l, string_map) )
+) // map_struct
+
+}
+
+/**
+ * Test the bulk serialization trait
+ */
+TEST(SerializeTest, BulkTrait)
+{
+    EXPECT_TRUE (f1d::is_bulk_serializable<test_serialize::dense_struct>::value);
+    EXPECT_FALSE(f1d::is_bulk_serializable<test_serialize::padded_struct>::value);
+    EXPECT_FALSE(f1d::is_bulk_serializable<test_serialize::heavy_struct>::value);
+
+    EXPECT_EQ(static_cast<size_t>(test_serialize::dense_struct::packed_size),
+        sizeof(int) + sizeof(int) + sizeof(float));
+    EXPECT_EQ(static_cast<size_t>(test_serialize::padded_struct::packed_size),
+        sizeof(char) + sizeof(double) + sizeof(short));
+}
+
+/**
+ * Test round trips of trivially copyable structs
+ */
+TEST(SerializeTest, TrivialRoundTrip)
+{
+    char buffer[64];
+
+    test_serialize::dense_struct ds1, ds2;
+    ds1.a = 1;
+    ds1.b = -2;
+    ds1.c = 3.5f;
+
+    ASSERT_EQ(ds1.get_serialized_size(), 12);
+    ASSERT_EQ(ds1.serialize(buffer, sizeof(buffer)), 12);
+    ASSERT_EQ(ds2.deserialize(buffer, 12), 12);
+
+    EXPECT_EQ(ds2.a, 1);
+    EXPECT_EQ(ds2.b, -2);
+    EXPECT_EQ(ds2.c, 3.5f);
+
+    test_serialize::padded_struct ps1, ps2;
+    ps1.d = 'x';
+    ps1.e = 0.25;
+    ps1.f = 300;
+
+    ASSERT_EQ(ps1.get_serialized_size(), 11);
+    ASSERT_EQ(ps1.serialize(buffer, sizeof(buffer)), 11);
+
+    EXPECT_EQ(buffer[0], 'x');
+
+    ASSERT_EQ(ps2.deserialize(buffer, 11), 11);
+
+    EXPECT_EQ(ps2.d, 'x');
+    EXPECT_EQ(ps2.e, 0.25);
+    EXPECT_EQ(ps2.f, 300);
+}
+
+/**
+ * Test round trips of structs with variable-length fields
+ */
+TEST(SerializeTest, HeavyRoundTrip)
+{
+    std::vector<char> buffer(1024);
+
+    test_serialize::heavy_struct hs1, hs2;
+    hs1.g = "hello";
+    hs1.h = -1.5;
+    hs1.i.push_back(4);
+    hs1.i.push_back(5);
+    hs1.j.push_back("a");
+    hs1.j.push_back("");
+    hs1.j.push_back("bcd");
+
+    const size_t expected = (8 + 5) + 8 + (8 + 2 * 4) + (8 + 9 + 8 + 11);
+
+    ASSERT_EQ(hs1.get_serialized_size(), expected);
+    ASSERT_EQ(hs1.serialize(&buffer[0], buffer.size()), expected);
+    ASSERT_EQ(hs2.deserialize(&buffer[0], expected), expected);
+
+    EXPECT_EQ(hs2.g, "hello");
+    EXPECT_EQ(hs2.h, -1.5);
+    EXPECT_EQ(hs2.i, hs1.i);
+    EXPECT_EQ(hs2.j, hs1.j);
+}
+
+/**
+ * Test buffers that are too small
+ */
+TEST(SerializeTest, Overflow)
+{
+    char buffer[64];
+    size_t size = 0;
+
+    test_serialize::dense_struct ds;
+    test_serialize::heavy_struct hs;
+    hs.g = "some long enough string";
+
+    EXPECT_EQ(ds.try_serialize(buffer, 11, size), f1d::buffer_overflow_error);
+    EXPECT_EQ(ds.try_deserialize(buffer, 11, size), f1d::buffer_overflow_error);
+    EXPECT_THROW(ds.serialize(buffer, 11), f1d::buffer_overflow_exception);
+    EXPECT_THROW(ds.deserialize(buffer, 11), f1d::buffer_overflow_exception);
+
+    EXPECT_EQ(hs.try_serialize(buffer, 20, size), f1d::buffer_overflow_error);
+    EXPECT_EQ(hs.try_serialize(buffer, sizeof(buffer), size), f1d::no_error);
+    EXPECT_EQ(size, hs.get_serialized_size());
+
+    for (size_t truncated = 0; truncated < size; truncated++) {
+        test_serialize::heavy_struct hs2;
+        EXPECT_EQ(hs2.try_deserialize(buffer, truncated, size),
+            f1d::buffer_overflow_error);
+    }
+}
+
+/**
+ * Test that fields without a serializer only fail when serialized
+ */
+TEST(SerializeTest, UnserializableField)
+{
+    test_serialize::map_struct ms1;
+    ms1.k = 1;
+    ms1.l["one"] = 1;
+
+    test_serialize::map_struct ms2(ms1);
+
+    EXPECT_FALSE(f1d::is_bulk_serializable<test_serialize::map_struct>::value);
+    EXPECT_TRUE(ms1 == ms2);
+    EXPECT_EQ(ms2.l.at("one"), 1);
+    EXPECT_EQ(test_serialize::map_struct::get_field_index("l"), 1u);
+}
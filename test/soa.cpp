@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <f1d/soa.hpp>
+#include <gtest/gtest.h>
+#include <typeinfo>
+
+#define SOA_TEST_FIELDS \
+    ( (price,    double     ) ) \
+    ( (quantity, int        ) ) \
+    ( (side,     char       ) ) \
+    ( (symbol,   std::string) )
+
+namespace test_soa {
+
+F1D_STRUCT_MAKE(soa_struct, SOA_TEST_FIELDS)
+
+F1D_SOA_MAKE(soa_struct, SOA_TEST_FIELDS)
+
+struct column_sizes
+{
+    size_t total;
+
+    column_sizes() :
+        total(0)
+    {
+    }
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V& v)
+    {
+        total += v.size();
+    }
+};
+
+struct column_scale
+{
+    template <unsigned int I, typename S, typename T>
+    void operator ()(f1d::column<T>& v) const
+    {
+        scale(v, typename test_soa::traits::value_type<S, I>::type());
+    }
+
+    template <typename T>
+    void scale(f1d::column<T>&, const std::string&) const
+    {
+    }
+
+    template <typename T, typename U>
+    void scale(f1d::column<T>& v, U) const
+    {
+        for (size_t i = 0; i < v.size(); i++)
+            v[i] *= 2;
+    }
+};
+
+soa_struct make(unsigned int i)
+{
+    soa_struct ms;
+    ms.price = 1.5 * i;
+    ms.quantity = -static_cast<int>(i);
+    ms.side = 'a' + i % 26;
+    ms.symbol = std::string(i % 7 + 1, 'x');
+    return ms;
+}
+
+}
+
+/**
+ * Test push_back and element access
+ */
+TEST(SoATest, PushBackAndAccess)
+{
+    test_soa::soa_struct_soa soa;
+
+    EXPECT_TRUE(soa.empty());
+    EXPECT_EQ(static_cast<unsigned int>(test_soa::soa_struct_soa::num_fields), 4);
+
+    for (unsigned int i = 0; i < 100; i++)
+        soa.push_back(test_soa::make(i));
+
+    ASSERT_EQ(soa.size(), 100);
+
+    for (unsigned int i = 0; i < 100; i++) {
+
+        const test_soa::soa_struct ms = soa[i];
+
+        EXPECT_EQ(ms.price, 1.5 * i);
+        EXPECT_EQ(ms.quantity, -static_cast<int>(i));
+        EXPECT_EQ(ms.side, 'a' + i % 26);
+        EXPECT_EQ(ms.symbol, std::string(i % 7 + 1, 'x'));
+
+        EXPECT_EQ(soa[i].price, 1.5 * i);
+        EXPECT_EQ(soa.quantity[i], -static_cast<int>(i));
+    }
+
+    soa.clear();
+
+    EXPECT_TRUE(soa.empty());
+}
+
+/**
+ * Test writing through the reference proxy
+ */
+TEST(SoATest, ProxyAssign)
+{
+    test_soa::soa_struct_soa soa;
+
+    soa.push_back(test_soa::make(1));
+    soa.push_back(test_soa::make(2));
+
+    soa[0].quantity = 42;
+    EXPECT_EQ(soa.quantity[0], 42);
+
+    soa[0] = test_soa::make(5);
+    EXPECT_EQ(soa.price[0], 7.5);
+    EXPECT_EQ(soa.symbol[0], "xxxxxx");
+
+    soa[1] = soa[0];
+    EXPECT_EQ(soa.quantity[1], -5);
+    EXPECT_EQ(soa.side[1], 'f');
+
+    const test_soa::soa_struct_soa& csoa = soa;
+    const test_soa::soa_struct ms = csoa[1];
+    EXPECT_EQ(ms.symbol, "xxxxxx");
+}
+
+/**
+ * Test the alignment and contiguity of the columns
+ */
+TEST(SoATest, ColumnData)
+{
+    test_soa::soa_struct_soa soa;
+
+    for (unsigned int i = 0; i < 33; i++)
+        soa.push_back(test_soa::make(i));
+
+    const double* prices = soa.price.data();
+    const int* quantities = soa.quantity.data();
+
+    EXPECT_EQ(reinterpret_cast<size_t>(prices) % F1D_COLUMN_ALIGNMENT, 0);
+    EXPECT_EQ(reinterpret_cast<size_t>(quantities) % F1D_COLUMN_ALIGNMENT, 0);
+
+    for (unsigned int i = 0; i < 33; i++) {
+        EXPECT_EQ(prices[i], 1.5 * i);
+        EXPECT_EQ(quantities[i], -static_cast<int>(i));
+    }
+
+    soa.reserve(1000);
+
+    EXPECT_GE(soa.price.capacity(), 1000);
+    EXPECT_EQ(soa.size(), 33);
+    EXPECT_EQ(soa.symbol[32], std::string(32 % 7 + 1, 'x'));
+}
+
+/**
+ * Test the column visitors
+ */
+TEST(SoATest, ApplyColumns)
+{
+    test_soa::soa_struct_soa soa;
+
+    for (unsigned int i = 0; i < 10; i++)
+        soa.push_back(test_soa::make(i));
+
+    test_soa::column_sizes f1;
+    soa.capply(f1);
+
+    EXPECT_EQ(f1.total, 40);
+
+    const test_soa::column_scale f2;
+    soa.apply(f2);
+
+    EXPECT_EQ(soa.price[3], 9.0);
+    EXPECT_EQ(soa.quantity[3], -6);
+    EXPECT_EQ(soa.side[0], static_cast<char>('a' * 2));
+    EXPECT_EQ(soa.symbol[3], "xxxx");
+}
+
+/**
+ * Test copying the container
+ */
+TEST(SoATest, Copy)
+{
+    test_soa::soa_struct_soa soa1;
+
+    for (unsigned int i = 0; i < 10; i++)
+        soa1.push_back(test_soa::make(i));
+
+    test_soa::soa_struct_soa soa2(soa1);
+    test_soa::soa_struct_soa soa3;
+
+    soa3 = soa1;
+    soa1.clear();
+
+    ASSERT_EQ(soa2.size(), 10);
+    ASSERT_EQ(soa3.size(), 10);
+
+    EXPECT_EQ(soa2.symbol[9], "xxx");
+    EXPECT_EQ(soa3.quantity[9], -9);
+}
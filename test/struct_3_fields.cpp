@@ -261,6 +261,28 @@ TEST(Struct3FieldsTest, AccessTypeSizeMetadata2)
     EXPECT_EQ(test::my_struct_3::get_type_sizes()[2], sizeof(char));
 }
 
+/**
+ * Test compile-time metadata access
+ */
+TEST(Struct3FieldsTest, AccessConstexprMetadata)
+{
+    static_assert(test::my_struct_3::get_num_fields() == 3, "num_fields");
+    static_assert(test::my_struct_3::get_type_size(0) == sizeof(float), "size");
+    static_assert(test::my_struct_3::get_type_size(2) == sizeof(char), "size");
+    static_assert(test::my_struct_3::get_type_sizes()[1] == sizeof(int), "size");
+    static_assert(test::my_struct_3::get_field_alignment(1) == alignof(int),
+        "alignment");
+    static_assert(test::my_struct_3::get_field_offset(2) ==
+        offsetof(test::my_struct_3, field3), "offset");
+    static_assert(test::my_struct_3::get_field_name(1)[5] == '2', "name");
+    static_assert(test::my_struct_3::get_type_name(2)[0] == 'c', "type name");
+    static_assert(test::my_struct_3::metadata::type_sizes[0] == sizeof(float),
+        "size");
+
+    EXPECT_THROW(test::my_struct_3::get_type_size(3), f1d::not_found_exception);
+    EXPECT_THROW(test::my_struct_3::get_field_offset(3), f1d::not_found_exception);
+}
+
 /**
  * Test metadata access
  */
@@ -289,6 +311,51 @@ TEST(Struct3FieldsTest, AccessIndexMetadata)
     }
 }
 
+/**
+ * Test metadata access
+ */
+TEST(Struct3FieldsTest, AccessIndexMetadata2)
+{
+    const char* buffer = "field2field3field1";
+
+    EXPECT_EQ(test::my_struct_3::get_field_index(buffer + 12, 6), 0);
+    EXPECT_EQ(test::my_struct_3::get_field_index(buffer + 0, 6), 1);
+    EXPECT_EQ(test::my_struct_3::get_field_index(buffer + 6, 6), 2);
+    EXPECT_THROW(test::my_struct_3::get_field_index(buffer, 5), f1d::not_found_exception);
+    EXPECT_THROW(test::my_struct_3::get_field_index(buffer, 7), f1d::not_found_exception);
+
+    EXPECT_EQ(test::my_struct_3::get_field_index(std::string("field1")), 0);
+    EXPECT_EQ(test::my_struct_3::get_field_index(boost::string_view("field2")), 1);
+    EXPECT_EQ(test::my_struct_3::get_field_index(boost::string_view(buffer + 6, 6)), 2);
+    EXPECT_THROW(test::my_struct_3::get_field_index(boost::string_view(buffer, 12)), f1d::not_found_exception);
+
+    EXPECT_EQ(f1d::name_hash("field1", 6), f1d::static_name_hash("field1", 6));
+    EXPECT_EQ(f1d::name_hash("", 0), f1d::static_name_hash("", 0));
+}
+
+/**
+ * Test metadata access without exceptions
+ */
+TEST(Struct3FieldsTest, TryAccessIndexMetadata)
+{
+    unsigned int index = 99;
+
+    EXPECT_EQ(test::my_struct_3::try_get_field_index("field1", index), f1d::no_error);
+    EXPECT_EQ(index, 0);
+    EXPECT_EQ(test::my_struct_3::try_get_field_index(std::string("field3"), index), f1d::no_error);
+    EXPECT_EQ(index, 2);
+    EXPECT_EQ(test::my_struct_3::try_get_field_index(boost::string_view("field2"), index), f1d::no_error);
+    EXPECT_EQ(index, 1);
+    EXPECT_EQ(test::my_struct_3::try_get_field_index("field3field4", 6, index), f1d::no_error);
+    EXPECT_EQ(index, 2);
+
+    index = 99;
+
+    EXPECT_EQ(test::my_struct_3::try_get_field_index("field4", index), f1d::not_found_error);
+    EXPECT_EQ(test::my_struct_3::try_get_field_index("", index), f1d::not_found_error);
+    EXPECT_EQ(index, 99);
+}
+
 /**
  * Test trait access
  */
@@ -880,6 +947,78 @@ TEST(Struct3FieldsTest, FactoryIncompleteSet2)
     EXPECT_EQ(ms.field3, v3);
 }
 
+/**
+ * Test the factory without exceptions
+ */
+TEST(Struct3FieldsTest, FactoryTry)
+{
+    const float v1 = 1.4f;
+    const int   v2 = -7;
+    const char  v3 = 'H';
+
+    test::my_struct_3 ms;
+    test::my_struct_3_factory f;
+
+    EXPECT_EQ(f.try_set_field1(v1), f1d::not_initialized_error);
+    EXPECT_EQ(f.try_end(), f1d::not_initialized_error);
+    EXPECT_EQ(f.try_begin(), f1d::no_error);
+    EXPECT_EQ(f.try_begin(), f1d::not_finished_error);
+    EXPECT_EQ(f.try_set_field1(v1), f1d::no_error);
+    EXPECT_EQ(f.try_set_field1(v1), f1d::already_set_error);
+    EXPECT_EQ(f.try_set_field2(v2), f1d::no_error);
+    EXPECT_EQ(f.try_end(), f1d::not_set_error);
+    EXPECT_EQ(f.try_set_field3(v3), f1d::no_error);
+    EXPECT_EQ(f.try_end(), f1d::no_error);
+    EXPECT_EQ(f.try_end(), f1d::already_finished_error);
+    EXPECT_EQ(f.try_set_field3(v3), f1d::already_finished_error);
+    ASSERT_NO_THROW(ms = f.get());
+
+    EXPECT_EQ(ms.field1, v1);
+    EXPECT_EQ(ms.field2, v2);
+    EXPECT_EQ(ms.field3, v3);
+
+    EXPECT_EQ(f.try_begin(), f1d::no_error);
+}
+
+/**
+ * Test the unchecked factory, misuse must not throw
+ */
+TEST(Struct3FieldsTest, FactoryUnchecked)
+{
+    const float v1 = 1.4f;
+    const int   v2 = -7;
+    const char  v3 = 'H';
+
+    test::my_struct_3 ms;
+    test::my_struct_3_basic_factory<f1d::unchecked_factory> f;
+
+    ASSERT_NO_THROW(f.set_field1(v1));
+    ASSERT_NO_THROW(f.begin());
+    ASSERT_NO_THROW(f.begin());
+    ASSERT_NO_THROW(f.set_field2(v1));
+    ASSERT_NO_THROW(f.set_field2(v2));
+    ASSERT_NO_THROW(f.end());
+    ASSERT_NO_THROW(f.end());
+    ASSERT_NO_THROW(f.set_field3(v3));
+    ASSERT_NO_THROW(ms = f.get());
+
+    EXPECT_EQ(f.get_field1(), v1);
+    EXPECT_EQ(f.get_field2(), v2);
+    EXPECT_EQ(f.get_field3(), v3);
+
+    EXPECT_EQ(ms.field1, v1);
+    EXPECT_EQ(ms.field2, v2);
+    EXPECT_EQ(ms.field3, v3);
+
+    test::types::field1_f field1(v3);
+
+    ASSERT_NO_THROW(field1(f));
+    EXPECT_EQ(f.get_field1(), static_cast<float>(v3));
+
+    EXPECT_EQ(typeid(test::my_struct_3_factory),
+        typeid(test::my_struct_3_basic_factory<f1d::checked_factory>));
+}
+
 /**
  * Test the field type constructors
  */
@@ -1212,6 +1351,62 @@ TEST(Struct3FieldsTest, CApplyMethod)
     EXPECT_EQ(f3.total, (v1 + 1 + v2 + 1 + v3 + 1));
 }
 
+/**
+ * Test the visit_field method
+ */
+TEST(Struct3FieldsTest, VisitFieldMethod)
+{
+    test::my_struct_3 ms;
+
+    ms.field1 = 10;
+    ms.field2 = -7;
+    ms.field3 = 'H';
+
+    const test::funct_3_2 f2;
+    test::funct_3_4 f4;
+
+    ms.visit_field(1, f2);
+
+    EXPECT_EQ(ms.field1, 10);
+    EXPECT_EQ(ms.field2, -6);
+    EXPECT_EQ(ms.field3, 'H');
+
+    ms.visit_field(0, f4);
+
+    EXPECT_EQ(ms.field1, 11);
+    EXPECT_EQ(ms.field2, -6);
+    EXPECT_EQ(f4.total, 11);
+
+    EXPECT_EQ(ms.try_visit_field(3, f4), f1d::not_found_error);
+    EXPECT_THROW(ms.visit_field(3, f2), f1d::not_found_exception);
+    EXPECT_EQ(f4.total, 11);
+}
+
+/**
+ * Test the cvisit_field method
+ */
+TEST(Struct3FieldsTest, CVisitFieldMethod)
+{
+    test::my_struct_3 ms;
+
+    ms.field1 = 10;
+    ms.field2 = -7;
+    ms.field3 = 'H';
+
+    const test::my_struct_3& cms = ms;
+    test::funct_3_3 f3;
+
+    cms.cvisit_field(2, f3);
+    EXPECT_EQ(f3.total, 'H' + 1);
+
+    cms.cvisit_field(1, f3);
+    EXPECT_EQ(f3.total, 'H' + 1 - 6);
+
+    EXPECT_EQ(cms.try_cvisit_field(1, test::funct_3_1()), f1d::no_error);
+    EXPECT_EQ(cms.try_cvisit_field(5, f3), f1d::not_found_error);
+    EXPECT_THROW(cms.cvisit_field(5, f3), f1d::not_found_exception);
+}
+
 /**
  * Test factory set from field wrappers without error
  */
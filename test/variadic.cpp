@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef F1D_VARIADIC_BACKEND
+#define F1D_VARIADIC_BACKEND
+#endif
+
+#include <f1d/fields.hpp>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define TEST_VARIADIC_FIELDS \
+    ( (id,    int        ) ) \
+    ( (score, double     ) ) \
+    ( (tag,   char       ) ) \
+    ( (label, std::string) )
+
+namespace test_variadic {
+
+F1D_STRUCT_MAKE(variadic_struct, TEST_VARIADIC_FIELDS)
+
+namespace packed {
+
+F1D_STRUCT_MAKE_PACKED(packed_struct, TEST_VARIADIC_FIELDS)
+
+}
+
+namespace pp {
+
+F1D_STRUCT_MAKE_S1(pp_struct, 4, TEST_VARIADIC_FIELDS, F1D_BASE_TRAITS,
+    F1D_LAYOUT_PLAIN)
+
+}
+
+namespace wide {
+
+F1D_STRUCT_MAKE(wide_struct,
+    ( (f00, int) ) ( (f01, int) ) ( (f02, int) ) ( (f03, int) )
+    ( (f04, int) ) ( (f05, int) ) ( (f06, int) ) ( (f07, int) )
+    ( (f08, int) ) ( (f09, int) ) ( (f10, int) ) ( (f11, int) )
+    ( (f12, int) ) ( (f13, int) ) ( (f14, int) ) ( (f15, int) )
+    ( (f16, int) ) ( (f17, int) ) ( (f18, int) ) ( (f19, int) )
+    ( (f20, int) ) ( (f21, int) ) ( (f22, int) ) ( (f23, int) )
+    ( (alpha, int) ) ( (beta, int) ) ( (gamma, int) ) ( (delta, int) )
+) // wide_struct
+
+}
+
+struct name_collector
+{
+    std::vector<std::string> names;
+
+    template <unsigned int I, typename S, typename V>
+    void operator ()(const V&)
+    {
+        names.push_back(S::get_field_name(I));
+    }
+};
+
+}
+
+/**
+ * Test that both backends produce the same metadata
+ */
+TEST(VariadicTest, Metadata)
+{
+    typedef test_variadic::variadic_struct V;
+    typedef test_variadic::pp::pp_struct P;
+
+    static_assert(V::get_type_size(1) == sizeof(double), "size");
+    static_assert(V::get_field_offset(2) == offsetof(V, tag), "offset");
+    static_assert(V::get_field_name(0)[0] == 'i', "name");
+    static_assert(test_variadic::packed::packed_struct::get_field_offset(1)
+        == 0, "packed offset");
+
+    EXPECT_EQ(V::get_num_fields(), P::get_num_fields());
+    EXPECT_EQ(static_cast<size_t>(V::packed_size),
+        static_cast<size_t>(P::packed_size));
+    EXPECT_STREQ(V::get_struct_name(), "variadic_struct");
+
+    for (unsigned int i = 0; i < V::num_fields; i++) {
+        EXPECT_STREQ(V::get_field_name(i), P::get_field_name(i));
+        EXPECT_STREQ(V::get_type_name(i), P::get_type_name(i));
+        EXPECT_EQ(V::get_type_size(i), P::get_type_size(i));
+        EXPECT_EQ(V::get_field_alignment(i), P::get_field_alignment(i));
+        EXPECT_EQ(V::get_field_offset(i), P::get_field_offset(i));
+    }
+
+    EXPECT_EQ(V::get_field_offset(1), offsetof(V, score));
+    EXPECT_STREQ(V::get_field_names()[4], "");
+}
+
+/**
+ * Test the name lookup of the variadic backend
+ */
+TEST(VariadicTest, Lookup)
+{
+    typedef test_variadic::variadic_struct V;
+
+    EXPECT_EQ(V::get_field_index("id"), 0u);
+    EXPECT_EQ(V::get_field_index("score"), 1u);
+    EXPECT_EQ(V::get_field_index(std::string("label")), 3u);
+
+    unsigned int index = 99;
+
+    EXPECT_EQ(V::try_get_field_index("scor", index), f1d::not_found_error);
+    EXPECT_EQ(V::try_get_field_index("scores", index), f1d::not_found_error);
+    EXPECT_EQ(index, 99u);
+    EXPECT_THROW(V::get_field_index("missing"), f1d::not_found_exception);
+}
+
+/**
+ * Test the sorted hash lookup of the variadic backend on a struct with
+ * more fields than a linear scan would be used for
+ */
+TEST(VariadicTest, LookupWide)
+{
+    typedef test_variadic::wide::wide_struct W;
+    typedef W::field_table T;
+
+    static constexpr f1d::name_hash_t colliding[] = { 1, 2, 2, 3, 4 };
+    static_assert(!f1d::detail::hashes_increasing(colliding, 0, 5),
+        "collision");
+    static_assert(T::sorted_hashes[0] < T::sorted_hashes[1], "sorted");
+
+    for (unsigned int i = 1; i < W::num_fields; i++)
+        EXPECT_LT(T::sorted_hashes[i - 1], T::sorted_hashes[i]);
+
+    for (unsigned int i = 0; i < W::num_fields; i++)
+        EXPECT_EQ(W::get_field_index(W::get_field_name(i)), i);
+
+    EXPECT_EQ(W::get_field_index("f00"), 0u);
+    EXPECT_EQ(W::get_field_index("f23"), 23u);
+    EXPECT_EQ(W::get_field_index(std::string("delta")), 27u);
+
+    unsigned int index = 99;
+
+    EXPECT_EQ(W::try_get_field_index("f24", index), f1d::not_found_error);
+    EXPECT_EQ(W::try_get_field_index("f0", index), f1d::not_found_error);
+    EXPECT_EQ(W::try_get_field_index("", index), f1d::not_found_error);
+    EXPECT_EQ(index, 99u);
+}
+
+/**
+ * Test the traits of the variadic backend
+ */
+TEST(VariadicTest, Traits)
+{
+    using namespace test_variadic;
+
+    bool same = std::is_same<
+        traits::value_type<variadic_struct, 3>::type, std::string>::value;
+    EXPECT_TRUE(same);
+
+    same = std::is_same<
+        traits::value_type<variadic_struct, 4>::type, void>::value;
+    EXPECT_TRUE(same);
+
+    same = std::is_same<
+        traits::field_wrapper_type<variadic_struct, 2>::type,
+        types::tag_f>::value;
+    EXPECT_TRUE(same);
+
+    same = std::is_same<
+        traits::field_wrapper_type<variadic_struct, 4>::type, void>::value;
+    EXPECT_TRUE(same);
+
+    EXPECT_EQ(static_cast<unsigned int>(
+        traits::field_index<types::score_f>::value), 1u);
+    EXPECT_EQ(static_cast<unsigned int>(
+        traits::num_fields<variadic_struct>::value), 4u);
+}
+
+/**
+ * Test apply, the factory and the wrappers with the variadic backend
+ */
+TEST(VariadicTest, ApplyAndFactory)
+{
+    using namespace test_variadic;
+
+    variadic_struct_factory factory;
+
+    factory.begin();
+    factory.set_id(7);
+    factory.set_score(0.5);
+    types::tag_f('t')(factory);
+    factory.set_label("seven");
+    factory.end();
+
+    const variadic_struct& s = factory.get();
+
+    EXPECT_EQ(s.id, 7);
+    EXPECT_EQ(s.label, "seven");
+    EXPECT_EQ(types::score_f(s).get(), 0.5);
+
+    name_collector collector;
+    s.capply(collector);
+
+    ASSERT_EQ(collector.names.size(), 4u);
+    EXPECT_EQ(collector.names[0], "id");
+    EXPECT_EQ(collector.names[3], "label");
+
+    char buffer[256];
+    const size_t written = s.serialize(buffer, sizeof(buffer));
+
+    variadic_struct r;
+    EXPECT_EQ(r.deserialize(buffer, written), written);
+    EXPECT_EQ(r.tag, 't');
+    EXPECT_EQ(r.label, "seven");
+}
+
+/**
+ * Test the runtime field dispatch of the variadic backend
+ */
+TEST(VariadicTest, VisitField)
+{
+    using namespace test_variadic;
+
+    variadic_struct s;
+
+    s.id = 1;
+    s.score = 2.0;
+    s.tag = 'x';
+    s.label = "one";
+
+    name_collector collector;
+
+    s.cvisit_field(3, collector);
+    s.visit_field(0, collector);
+
+    ASSERT_EQ(collector.names.size(), 2u);
+    EXPECT_EQ(collector.names[0], "label");
+    EXPECT_EQ(collector.names[1], "id");
+
+    EXPECT_EQ(s.try_visit_field(4, collector), f1d::not_found_error);
+    EXPECT_THROW(s.cvisit_field(4, collector), f1d::not_found_exception);
+}
+
+/**
+ * Test packed structs with the variadic backend
+ */
+TEST(VariadicTest, Packed)
+{
+    typedef test_variadic::packed::packed_struct S;
+
+    S s;
+
+    s.id() = 3;
+    s.score() = 2.5;
+    s.tag() = 'p';
+    s.label() = "three";
+
+    const char* base = reinterpret_cast<const char*>(&s);
+
+    EXPECT_EQ(S::get_field_offset(1),
+        static_cast<size_t>(reinterpret_cast<const char*>(&s.score()) -
+        base));
+    EXPECT_EQ(S::get_field_offset(2),
+        static_cast<size_t>(reinterpret_cast<const char*>(&s.tag()) -
+        base));
+
+    test_variadic::name_collector collector;
+    s.capply(collector);
+
+    ASSERT_EQ(collector.names.size(), 4u);
+    EXPECT_EQ(collector.names[1], "score");
+}
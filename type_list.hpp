@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018-2019 Caian Benedicto <caianbene@gmail.com>
+ *
+ * This file is part of f1d.
+ *
+ * f1d is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * f1d is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with f1d.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace f1d {
+
+/**
+ * Compile-time list of types.
+ */
+template <typename... Ts>
+struct type_list
+{
+    static const unsigned int size = sizeof...(Ts);
+};
+
+template <typename... Ts>
+const unsigned int type_list<Ts...>::size;
+
+/**
+ * Type at index I of a type list, void if out of range.
+ */
+template <unsigned int I, typename List>
+struct type_at;
+
+template <unsigned int I>
+struct type_at<I, type_list<> >
+{
+    typedef void type;
+};
+
+template <typename T, typename... Ts>
+struct type_at<0, type_list<T, Ts...> >
+{
+    typedef T type;
+};
+
+template <unsigned int I, typename T, typename... Ts>
+struct type_at<I, type_list<T, Ts...> > :
+    type_at<I - 1, type_list<Ts...> >
+{
+};
+
+/**
+ * Compile-time list of indices, make_index_list<N>::type holds 0 to N-1.
+ */
+template <unsigned int... Is>
+struct index_list
+{
+};
+
+template <unsigned int N, unsigned int... Is>
+struct make_index_list :
+    make_index_list<N - 1, N - 1, Is...>
+{
+};
+
+template <unsigned int... Is>
+struct make_index_list<0, Is...>
+{
+    typedef index_list<Is...> type;
+};
+
+}